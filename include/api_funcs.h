@@ -20,6 +20,7 @@ unsigned easypap_number_of_gpus_ocl (void);
 unsigned easypap_gpu_lane (unsigned gpu_no);
 int easypap_mpi_rank (void);
 int easypap_mpi_size (void);
+int easypap_mpi_thread_multiple (void);
 void easypap_check_mpi (void);
 void easypap_vec_check (unsigned vec_width_in_bytes, direction_t dir);
 int easypap_proc_is_master (void);
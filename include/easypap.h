@@ -17,6 +17,7 @@
 #include "minmax.h"
 #include "ezp_ctx.h"
 #include "ezp_alloc.h"
+#include "ezp_checkpoint.h"
 
 #ifdef ENABLE_MPI
 #include <mpi.h>
@@ -0,0 +1,32 @@
+#ifndef EZP_CHECKPOINT_IS_DEF
+#define EZP_CHECKPOINT_IS_DEF
+
+#include <stddef.h>
+
+// Part of the global simulation state owned by the current process.
+// The global state is seen as a flat array of 'total' bytes (e.g. the
+// DIM x DIM cells of a table, in row-major order): each process describes
+// the slice [offset, offset + size) it is responsible for, and where its
+// local copy lives in memory. Processes owning nothing just set size to 0.
+typedef struct ezp_ckpt_region
+{
+  void *base;
+  size_t offset;
+  size_t size;
+  size_t total;
+} ezp_ckpt_region_t;
+
+extern unsigned checkpoint_period;
+extern char *restart_file;
+
+// Collectively write the state of the current kernel into 'filename'.
+// Kernels describe their state through a ${kernel}_checkpoint_${variant}
+// hook (or ${kernel}_checkpoint); when no such hook exists, the whole image
+// (2D) or mesh data (3D) is saved.
+void ezp_checkpoint_save (const char *filename, unsigned iteration);
+
+// Collectively reload the state saved in 'filename' and return the iteration
+// at which the computation should resume.
+unsigned ezp_checkpoint_restore (const char *filename);
+
+#endif
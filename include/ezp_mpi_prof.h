@@ -0,0 +1,47 @@
+#ifndef EZP_MPI_PROF_IS_DEF
+#define EZP_MPI_PROF_IS_DEF
+
+#include <stdint.h>
+
+// Lightweight MPI communication profiler (--mpi-profile). MPI calls are
+// intercepted through the PMPI profiling interface, so kernels do not need to
+// be modified. For each category, the number of calls, the number of bytes
+// and the time spent inside MPI are accumulated on each process.
+typedef enum
+{
+  EZP_MPI_SEND, // MPI_Send, MPI_Isend
+  EZP_MPI_RECV, // MPI_Recv, MPI_Irecv (bytes = size of posted buffers)
+  EZP_MPI_WAIT, // MPI_Wait, MPI_Waitall
+  EZP_MPI_COLL, // collectives (bytes = local contribution)
+  EZP_MPI_NB_CATEGORIES
+} ezp_mpi_category_t;
+
+typedef struct
+{
+  uint64_t calls;
+  uint64_t bytes;
+  uint64_t time; // in µs
+} ezp_mpi_stat_t;
+
+extern unsigned mpi_profiling;
+
+#ifdef ENABLE_MPI
+
+// Communications are displayed on 'trace_lane' when traces are recorded
+// (-1 otherwise)
+void ezp_mpi_prof_init (int trace_lane);
+
+// Flush statistics gathered since the previous call to the per-process
+// data/perf/mpi_prof.<rank>.csv file
+void ezp_mpi_prof_end_iteration (unsigned iteration);
+
+// Collective: 'msgs' and 'bytes' are the total number of messages/bytes sent
+// by all processes, 'time' is the maximum time spent in MPI by a process
+// (results are only available on the master process)
+void ezp_mpi_prof_get_totals (uint64_t *msgs, uint64_t *bytes, uint64_t *time);
+
+void ezp_mpi_prof_finalize (void);
+
+#endif
+
+#endif
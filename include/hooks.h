@@ -11,6 +11,9 @@ typedef int (*patch_func_t) (int, int);
 typedef void (*debug_1d_t) (int);
 typedef void (*debug_2d_t) (int, int);
 
+struct ezp_ckpt_region;
+typedef void (*ckpt_func_t) (struct ezp_ckpt_region *);
+
 extern draw_func_t the_config;
 extern void_func_t the_init;
 extern void_func_t the_first_touch;
@@ -23,6 +26,7 @@ extern debug_2d_t the_2d_debug;
 extern debug_1d_t the_1d_overlay;
 extern debug_2d_t the_2d_overlay;
 extern void_func_t the_send_data;
+extern ckpt_func_t the_checkpoint;
 
 void *bind_it (const char *kernel, const char *s, const char *variant, int print_error);
 void *hooks_find_symbol (char *symbol);
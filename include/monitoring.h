@@ -84,4 +84,13 @@ static inline void monitoring_gpu_tile (unsigned x, unsigned y, unsigned w,
   ezm_2D_ext (ezp_monitor, start, end, cpu, x, y, w, h, task_type, task_id);
 }
 
+// MPI
+
+// Time spent by 'cpu' waiting for MPI communications or collectives
+static inline void monitoring_mpi_wait (unsigned cpu, long start, long end)
+{
+  ezm_2D_ext (ezp_monitor, start, end, cpu, 0, 0, 0, 0, TASK_TYPE_MPI_WAIT,
+              0);
+}
+
 #endif
@@ -2,6 +2,7 @@
 #include "easypap.h"
 
 #include <omp.h>
+#include <string.h>
 
 ///////////////////////////// Sequential version (tiled)
 // Suggested cmdline(s):
@@ -72,3 +73,251 @@ unsigned blur_compute_tiled (unsigned nb_iter)
 
   return 0;
 }
+
+///////////////////////////// Tiled parallel version (omp_tiled)
+// Suggested cmdline(s):
+// ./run -l data/img/1024.png -k blur -v omp_tiled -wt opt -ts 32
+//
+unsigned blur_compute_omp_tiled (unsigned nb_iter)
+{
+  for (unsigned it = 1; it <= nb_iter; it++) {
+
+#pragma omp parallel for collapse(2) schedule(runtime)
+    for (int y = 0; y < DIM; y += TILE_H)
+      for (int x = 0; x < DIM; x += TILE_W)
+        do_tile (x, y, TILE_W, TILE_H);
+
+    swap_images ();
+  }
+
+  return 0;
+}
+
+///////////////////////////// Temporal blocking version (tblock)
+// Suggested cmdline(s):
+// ./run -l data/img/1024.png -k blur -v tblock -ts 64 -i 100
+//
+// Instead of streaming the whole image through memory at each iteration,
+// each tile is loaded once into a thread-private buffer, surrounded by a
+// TBLOCK_K pixels halo, and TBLOCK_K iterations are performed in cache: at
+// each step, the valid area shrinks by one pixel on each side (except along
+// the image border), so that the tile itself is valid after TBLOCK_K steps.
+// Halo pixels are computed redundantly by neighbouring tiles. Pixels are
+// averaged exactly as in blur_do_tile_default, so results are bit-identical.
+
+#define TBLOCK_K 4
+
+// Compute area [x0, x1[ x [y0, y1[ (image coordinates) of dst from src. Both
+// buffers have the given stride and start at pixel (gx, gy).
+static void tblock_step (const uint32_t *src, uint32_t *dst, int stride,
+                         int gx, int gy, int x0, int y0, int x1, int y1)
+{
+  for (int i = y0; i < y1; i++)
+    for (int j = x0; j < x1; j++) {
+      unsigned r = 0, g = 0, b = 0, a = 0, n = 0;
+
+      int i_d = (i > 0) ? i - 1 : i;
+      int i_f = (i < DIM - 1) ? i + 1 : i;
+      int j_d = (j > 0) ? j - 1 : j;
+      int j_f = (j < DIM - 1) ? j + 1 : j;
+
+      for (int yloc = i_d; yloc <= i_f; yloc++)
+        for (int xloc = j_d; xloc <= j_f; xloc++) {
+          unsigned c = src[(yloc - gy) * stride + (xloc - gx)];
+          r += ezv_c2r (c);
+          g += ezv_c2g (c);
+          b += ezv_c2b (c);
+          a += ezv_c2a (c);
+          n += 1;
+        }
+
+      r /= n;
+      g /= n;
+      b /= n;
+      a /= n;
+
+      dst[(i - gy) * stride + (j - gx)] = ezv_rgba (r, g, b, a);
+    }
+}
+
+static void tblock_tile (int x, int y, int width, int height, int k,
+                         uint32_t *buf[2])
+{
+  // Loaded area, clipped to the image
+  const int gx = MAX (x - k, 0), gx1 = MIN (x + width + k, DIM);
+  const int gy = MAX (y - k, 0), gy1 = MIN (y + height + k, DIM);
+  const int stride = gx1 - gx;
+
+  for (int i = gy; i < gy1; i++)
+    memcpy (buf[0] + (i - gy) * stride, &cur_img (i, gx),
+            stride * sizeof (uint32_t));
+
+  for (int s = 1; s <= k; s++)
+    tblock_step (buf[(s - 1) & 1], buf[s & 1], stride, gx, gy,
+                 gx > 0 ? gx + s : 0, gy > 0 ? gy + s : 0,
+                 gx1 < DIM ? gx1 - s : DIM, gy1 < DIM ? gy1 - s : DIM);
+
+  for (int i = y; i < y + height; i++)
+    memcpy (&next_img (i, x), buf[k & 1] + (i - gy) * stride + (x - gx),
+            width * sizeof (uint32_t));
+}
+
+unsigned blur_compute_tblock (unsigned nb_iter)
+{
+  const size_t size =
+      (TILE_W + 2 * TBLOCK_K) * (TILE_H + 2 * TBLOCK_K) * sizeof (uint32_t);
+
+#pragma omp parallel
+  {
+    uint32_t *buf[2] = {malloc (size), malloc (size)};
+
+    for (unsigned it = 1; it <= nb_iter; it += TBLOCK_K) {
+      const int k = MIN (TBLOCK_K, nb_iter - it + 1);
+
+#pragma omp for collapse(2) schedule(runtime)
+      for (int y = 0; y < DIM; y += TILE_H)
+        for (int x = 0; x < DIM; x += TILE_W) {
+          monitoring_start (omp_get_thread_num ());
+          tblock_tile (x, y, TILE_W, TILE_H, k, buf);
+          monitoring_end_tile (x, y, TILE_W, TILE_H, omp_get_thread_num ());
+        }
+
+#pragma omp single
+      swap_images ();
+    }
+
+    free (buf[0]);
+    free (buf[1]);
+  }
+
+  return 0;
+}
+
+///////////////////////////// Optimized tile versions (opt, opt_avx2)
+// Tiles which do not touch the image border always average 9 pixels: they
+// need neither bounds checks nor a variable division. The 4 channels of a
+// pixel are processed the same way, so pixels are handled as bytes
+// regardless of the RGBA layout, and x / 9 is computed as (x * 7282) >> 16
+// (exact for x <= 9 * 255).
+// Border tiles use the default version.
+
+#define DIV9_MUL 7282
+
+static void blur_interior (int x, int y, int width, int height)
+{
+  for (int i = y; i < y + height; i++) {
+    const uint8_t *top = (const uint8_t *)&cur_img (i - 1, 0);
+    const uint8_t *mid = (const uint8_t *)&cur_img (i, 0);
+    const uint8_t *bot = (const uint8_t *)&cur_img (i + 1, 0);
+    uint8_t *dst       = (uint8_t *)&next_img (i, 0);
+
+    for (int k = 4 * x; k < 4 * (x + width); k++) {
+      unsigned s = top[k - 4] + top[k] + top[k + 4] + mid[k - 4] + mid[k] +
+                   mid[k + 4] + bot[k - 4] + bot[k] + bot[k + 4];
+      dst[k] = (s * DIV9_MUL) >> 16;
+    }
+  }
+}
+
+int blur_do_tile_opt (int x, int y, int width, int height)
+{
+  if (x == 0 || y == 0 || x + width == DIM || y + height == DIM)
+    return blur_do_tile_default (x, y, width, height);
+
+  blur_interior (x, y, width, height);
+
+  return 0;
+}
+
+#ifdef ENABLE_VECTO
+#include <immintrin.h>
+
+#if __AVX2__ == 1
+
+// Suggested cmdline(s):
+// ./run -l data/img/1024.png -k blur -v omp_tiled -wt opt_avx2 -ts 32
+//
+// Separable version: the vertical sum of 4 pixels (16 channels on 16-bit
+// lanes) is computed once per column vector, and the horizontal 3-tap sum is
+// built from the previous, current and next vertical sums.
+
+void blur_tile_check_opt_avx2 (void)
+{
+  // Tile width must be larger than AVX vector size
+  easypap_vec_check (AVX_VEC_SIZE_INT, DIR_HORIZONTAL);
+}
+
+// Vertical sum of pixels [j, j + 4) of three consecutive rows
+static inline __m256i vsum_avx2 (const uint32_t *top, const uint32_t *mid,
+                                 const uint32_t *bot, int j)
+{
+  __m256i t =
+      _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *)(top + j)));
+  __m256i m =
+      _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *)(mid + j)));
+  __m256i b =
+      _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *)(bot + j)));
+
+  return _mm256_add_epi16 (_mm256_add_epi16 (t, m), b);
+}
+
+// Horizontal 3-tap sum of the 4 pixels of cur (one pixel = 8 bytes), divided
+// by 9
+static inline __m256i hsum_avx2 (__m256i prev, __m256i cur, __m256i next)
+{
+  // Pixels shifted by one to the right / to the left
+  __m256i left  = _mm256_alignr_epi8 (
+      cur, _mm256_permute2x128_si256 (prev, cur, 0x21), 8);
+  __m256i right = _mm256_alignr_epi8 (
+      _mm256_permute2x128_si256 (cur, next, 0x21), cur, 8);
+  __m256i s = _mm256_add_epi16 (_mm256_add_epi16 (left, cur), right);
+
+  return _mm256_mulhi_epu16 (s, _mm256_set1_epi16 (DIV9_MUL));
+}
+
+static void blur_interior_avx2 (int x, int y, int width, int height)
+{
+  for (int i = y; i < y + height; i++) {
+    const uint32_t *top = &cur_img (i - 1, 0);
+    const uint32_t *mid = &cur_img (i, 0);
+    const uint32_t *bot = &cur_img (i + 1, 0);
+    int j               = x;
+
+    // The vector loop reads pixels [j - 4, j + 12)
+    if (j >= 4) {
+      __m256i prev = vsum_avx2 (top, mid, bot, j - 4);
+      __m256i cur  = vsum_avx2 (top, mid, bot, j);
+
+      for (; j + 8 <= x + width && j + 12 <= DIM; j += 8) {
+        __m256i next  = vsum_avx2 (top, mid, bot, j + 4);
+        __m256i next2 = vsum_avx2 (top, mid, bot, j + 8);
+        __m256i lo    = hsum_avx2 (prev, cur, next);
+        __m256i hi    = hsum_avx2 (cur, next, next2);
+
+        // packus interleaves 128-bit lanes: put pixels back in order
+        _mm256_storeu_si256 (
+            (__m256i *)&next_img (i, j),
+            _mm256_permute4x64_epi64 (_mm256_packus_epi16 (lo, hi), 0xD8));
+
+        prev = next;
+        cur  = next2;
+      }
+    }
+    if (j < x + width)
+      blur_interior (j, i, x + width - j, 1);
+  }
+}
+
+int blur_do_tile_opt_avx2 (int x, int y, int width, int height)
+{
+  if (x == 0 || y == 0 || x + width == DIM || y + height == DIM)
+    return blur_do_tile_default (x, y, width, height);
+
+  blur_interior_avx2 (x, y, width, height);
+
+  return 0;
+}
+
+#endif // AVX2
+
+#endif
@@ -803,14 +803,21 @@ void life_ft (void)
 
 ///////////////////////////// MPI
 
+// First row of each slab (size + 1 entries) when slabs are moved at runtime,
+// NULL when rows are statically split in DIM / size slabs
+static int *slab_bounds = NULL;
+
 int rankTop(int rank)
 {
+  if (slab_bounds != NULL)
+    return slab_bounds[rank];
+
   return (rank * DIM) / size;
 }
 
 int rankSize(int rank)
 {
-  return (((rank + 1) * DIM) / size) - ((rank * DIM) / size);
+  return rankTop(rank + 1) - rankTop(rank);
 }
 
 int rankBot(int rank)
@@ -852,6 +859,7 @@ static void exchange_halos()
 
   MPI_Status status;
   int tag = 0;
+  uint64_t start = ezp_gettime();
 
   // Send to top neighbor, receive from top
   if (rank > 0) {
@@ -868,6 +876,8 @@ static void exchange_halos()
     MPI_Recv(&cur_table(rankBot(rank), 0), DIM, MPI_CHAR, rank + 1, tag,
              MPI_COMM_WORLD, &status);
   }
+
+  monitoring_mpi_wait(omp_get_thread_num(), start, ezp_gettime());
 }
 
 void life_refresh_img_mpi()
@@ -1067,6 +1077,415 @@ unsigned life_compute_mpi_omp_border(unsigned nb_iter)
 
   return res;
 }
+
+///////////////////////////// MPI + OpenMP tasks (MPI_THREAD_MULTIPLE)
+//
+// Halo messages are no longer funneled through the master thread between two
+// parallel regions: each boundary tile sends its own part of the boundary row
+// as soon as it is computed, ghost rows are received in the background while
+// interior tiles are computed, and only boundary tiles wait for them (task
+// dependencies). Requires --mpi-thread-multiple.
+// Suggested cmdline:
+// ./run -k life -v mpi_omp_mt -mpi "-np 4" -mtm -a moultdiehard130 -n -i 100
+
+enum
+{
+  HALO_TOP,
+  HALO_BOT
+};
+
+// recv_reqs[parity][HALO_TOP/BOT][tile], send_reqs[HALO_TOP/BOT][tile]
+static MPI_Request *recv_reqs = NULL;
+static MPI_Request *send_reqs = NULL;
+
+#define recv_req(p, side, tx) (recv_reqs + ((p) * 2 + (side)) * NB_TILES_X + (tx))
+#define send_req(side, tx) (send_reqs + (side) * NB_TILES_X + (tx))
+
+void life_init_mpi_omp_mt (void)
+{
+  easypap_check_mpi ();
+  if (!easypap_mpi_thread_multiple ())
+    exit_with_error ("Variant mpi_omp_mt requires MPI_THREAD_MULTIPLE "
+                     "(use --mpi-thread-multiple)");
+
+  MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+  MPI_Comm_size (MPI_COMM_WORLD, &size);
+
+  life_init ();
+
+  if (recv_reqs == NULL) {
+    recv_reqs = malloc (4 * NB_TILES_X * sizeof (MPI_Request));
+    send_reqs = malloc (2 * NB_TILES_X * sizeof (MPI_Request));
+    for (int i = 0; i < 4 * NB_TILES_X; i++)
+      recv_reqs[i] = MPI_REQUEST_NULL;
+    for (int i = 0; i < 2 * NB_TILES_X; i++)
+      send_reqs[i] = MPI_REQUEST_NULL;
+  }
+}
+
+void life_refresh_img_mpi_omp_mt (void)
+{
+  life_refresh_img_mpi ();
+}
+
+// One message per tile column: the tag identifies the column, and messages
+// of successive generations are matched in order
+static void post_halo_recvs (cell_t *t, int parity)
+{
+  for (int tx = 0; tx < NB_TILES_X; tx++) {
+    if (rank > 0)
+      MPI_Irecv (table_cell (t, rankTop (rank) - 1, tx * TILE_W), TILE_W,
+                 MPI_CHAR, rank - 1, tx, MPI_COMM_WORLD,
+                 recv_req (parity, HALO_TOP, tx));
+    if (rank < size - 1)
+      MPI_Irecv (table_cell (t, rankBot (rank), tx * TILE_W), TILE_W,
+                 MPI_CHAR, rank + 1, tx, MPI_COMM_WORLD,
+                 recv_req (parity, HALO_BOT, tx));
+  }
+}
+
+static void post_halo_sends (cell_t *t, int tx, int top_row, int bot_row)
+{
+  if (top_row && rank > 0)
+    MPI_Isend (table_cell (t, rankTop (rank), tx * TILE_W), TILE_W, MPI_CHAR,
+               rank - 1, tx, MPI_COMM_WORLD, send_req (HALO_TOP, tx));
+  if (bot_row && rank < size - 1)
+    MPI_Isend (table_cell (t, rankBot (rank) - 1, tx * TILE_W), TILE_W,
+               MPI_CHAR, rank + 1, tx, MPI_COMM_WORLD,
+               send_req (HALO_BOT, tx));
+}
+
+unsigned life_compute_mpi_omp_mt (unsigned nb_iter)
+{
+  unsigned res           = 0;
+  unsigned myTop         = rankTop (rank);
+  unsigned myBot         = rankBot (rank);
+  int parity             = 0;
+  unsigned global_change = 1;
+  MPI_Request stop_req   = MPI_REQUEST_NULL;
+  // dependency tokens
+  int ghost_top, ghost_bot, no_ghost;
+
+  // Ghost rows of the initial table
+  post_halo_recvs (_table, parity);
+  for (int tx = 0; tx < NB_TILES_X; tx++)
+    post_halo_sends (_table, tx, 1, 1);
+  MPI_Waitall (2 * NB_TILES_X, send_reqs, MPI_STATUSES_IGNORE);
+
+#pragma omp parallel
+#pragma omp single
+  for (unsigned it = 1; it <= nb_iter; it++) {
+    unsigned change = 0;
+    int last        = (it == nb_iter);
+    cell_t *next    = _alternate_table;
+
+    // Ghost rows of the next generation are received while this one is
+    // being computed
+    if (!last)
+      post_halo_recvs (next, 1 - parity);
+
+#pragma omp taskgroup task_reduction(| : change)
+    {
+#pragma omp task depend(out : ghost_top) firstprivate(parity)
+      MPI_Waitall (NB_TILES_X, recv_req (parity, HALO_TOP, 0),
+                   MPI_STATUSES_IGNORE);
+#pragma omp task depend(out : ghost_bot) firstprivate(parity)
+      MPI_Waitall (NB_TILES_X, recv_req (parity, HALO_BOT, 0),
+                   MPI_STATUSES_IGNORE);
+
+      for (int y = myTop; y < myBot; y += TILE_H) {
+        int h       = (y + TILE_H > myBot) ? (myBot - y) : TILE_H;
+        int top_row = (y == myTop);
+        int bot_row = (y + h == myBot);
+        int *dep_t  = top_row ? &ghost_top : &no_ghost;
+        int *dep_b  = bot_row ? &ghost_bot : &no_ghost;
+
+        for (int x = 0; x < DIM; x += TILE_W) {
+          if (top_row || bot_row) {
+#pragma omp task in_reduction(| : change) depend(in : *dep_t, *dep_b)         \
+    firstprivate(x, y, h, top_row, bot_row, last, next)
+            {
+              change |= do_tile (x, y, TILE_W, h);
+              if (!last)
+                post_halo_sends (next, x / TILE_W, top_row, bot_row);
+            }
+          } else {
+#pragma omp task in_reduction(| : change) firstprivate(x, y, h)
+            change |= do_tile (x, y, TILE_W, h);
+          }
+        }
+      }
+    }
+
+    // next table is about to be read, so its boundary rows can't be
+    // overwritten before two generations: sends are completed here
+    MPI_Waitall (2 * NB_TILES_X, send_reqs, MPI_STATUSES_IGNORE);
+
+    swap_tables ();
+    parity = 1 - parity;
+
+    // Global stability is detected one generation late, so that the
+    // reduction overlaps with the computation of the next generation. All
+    // processes thus stop at the same iteration.
+    if (stop_req != MPI_REQUEST_NULL) {
+      MPI_Wait (&stop_req, MPI_STATUS_IGNORE);
+      if (!global_change) {
+        if (!last)
+          MPI_Waitall (2 * NB_TILES_X, recv_req (parity, HALO_TOP, 0),
+                       MPI_STATUSES_IGNORE);
+        res = it;
+        break;
+      }
+    }
+
+    global_change = change;
+    MPI_Iallreduce (MPI_IN_PLACE, &global_change, 1, MPI_UNSIGNED, MPI_BOR,
+                    MPI_COMM_WORLD, &stop_req);
+  }
+
+  if (stop_req != MPI_REQUEST_NULL) {
+    MPI_Wait (&stop_req, MPI_STATUS_IGNORE);
+    if (!global_change)
+      res = nb_iter;
+  }
+
+  return res;
+}
+
+///////////////////////////// MPI + lazy OpenMP with dynamic load balancing
+//
+// Slab boundaries are moved every LB_PERIOD generations so that each process
+// gets the same share of the compute time. The time measured by each process
+// is spread over its tile rows proportionally to the number of tiles actually
+// computed (dirty tiles), which gives a cheap per-row cost estimate. Rows are
+// then migrated between the previous and the new owners (mostly neighbours).
+// Suggested cmdline:
+// ./run -k life -v mpi_lazy_lb -mpi "-np 8" -a moultdiehard130 -s 2048 -ts 32 -n
+
+#define LB_PERIOD 16
+// Slabs are only moved when the slowest process exceeds the average by 10%
+#define LB_THRESHOLD 1.10
+
+static double *tile_row_cost   = NULL;
+static unsigned *tile_row_work = NULL;
+
+void life_init_mpi_lazy_lb (void)
+{
+  easypap_check_mpi ();
+  MPI_Comm_rank (MPI_COMM_WORLD, &rank);
+  MPI_Comm_size (MPI_COMM_WORLD, &size);
+
+  life_init ();
+
+  if (NB_TILES_Y < size)
+    exit_with_error ("Variant mpi_lazy_lb requires at least one row of tiles "
+                     "per process (%d rows, %d processes)",
+                     NB_TILES_Y, size);
+
+  if (slab_bounds == NULL) {
+    slab_bounds   = malloc ((size + 1) * sizeof (int));
+    tile_row_cost = calloc (NB_TILES_Y, sizeof (double));
+    tile_row_work = calloc (NB_TILES_Y, sizeof (unsigned));
+
+    // Initial slabs are aligned on tile rows
+    for (int r = 0; r <= size; r++)
+      slab_bounds[r] = (r * NB_TILES_Y / size) * TILE_H;
+  }
+}
+
+void life_refresh_img_mpi_lazy_lb (void)
+{
+  life_refresh_img_mpi ();
+}
+
+// Move rows so that process r owns tile rows [bounds[r], bounds[r + 1])
+static void migrate_slabs (const int *bounds)
+{
+  int new_top = bounds[rank] * TILE_H;
+  int new_bot = bounds[rank + 1] * TILE_H;
+  MPI_Request reqs[2 * size];
+  int n = 0;
+
+  for (int r = 0; r < size; r++) {
+    if (r == rank)
+      continue;
+
+    // Rows we own and r is going to own
+    int lo = MAX (rankTop (rank), bounds[r] * TILE_H);
+    int hi = MIN (rankBot (rank), bounds[r + 1] * TILE_H);
+    if (lo < hi)
+      MPI_Isend (&cur_table (lo, 0), (hi - lo) * DIM, MPI_CHAR, r, 1,
+                 MPI_COMM_WORLD, &reqs[n++]);
+
+    // Rows r owns and we are going to own
+    lo = MAX (rankTop (r), new_top);
+    hi = MIN (rankBot (r), new_bot);
+    if (lo < hi) {
+      MPI_Irecv (&cur_table (lo, 0), (hi - lo) * DIM, MPI_CHAR, r, 1,
+                 MPI_COMM_WORLD, &reqs[n++]);
+      // Our dirty maps know nothing about these rows, nor about their
+      // influence on the tile rows on each side (our former boundary rows
+      // become interior ones)
+      for (int ty = MAX (lo / TILE_H - 1, 0);
+           ty < MIN (hi / TILE_H + 1, NB_TILES_Y); ty++)
+        for (int tx = 0; tx < NB_TILES_X; tx++)
+          cur_dirty (ty, tx) = next_dirty (ty, tx) = 1;
+    }
+  }
+
+  MPI_Waitall (n, reqs, MPI_STATUSES_IGNORE);
+
+  for (int r = 0; r <= size; r++)
+    slab_bounds[r] = bounds[r] * TILE_H;
+}
+
+static void rebalance_slabs (uint64_t busy)
+{
+  int top = rankTop (rank) / TILE_H;
+  int bot = rankBot (rank) / TILE_H;
+  int counts[size], displs[size], bounds[size + 1];
+  double prefix[NB_TILES_Y + 1];
+  unsigned work = 0;
+
+  // Per tile row cost estimate. Each row gets a minimal share, since clean
+  // tiles still have to be checked.
+  for (int ty = top; ty < bot; ty++)
+    work += tile_row_work[ty] + 1;
+  for (int ty = top; ty < bot; ty++)
+    tile_row_cost[ty] = (double)busy * (tile_row_work[ty] + 1) / work;
+  memset (tile_row_work, 0, NB_TILES_Y * sizeof (unsigned));
+
+  for (int r = 0; r < size; r++) {
+    displs[r] = rankTop (r) / TILE_H;
+    counts[r] = rankSize (r) / TILE_H;
+  }
+  MPI_Allgatherv (MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, tile_row_cost, counts,
+                  displs, MPI_DOUBLE, MPI_COMM_WORLD);
+
+  prefix[0] = 0.0;
+  for (int ty = 0; ty < NB_TILES_Y; ty++)
+    prefix[ty + 1] = prefix[ty] + tile_row_cost[ty];
+
+  double total = prefix[NB_TILES_Y], slowest = 0.0;
+  for (int r = 0; r < size; r++) {
+    double t = prefix[displs[r] + counts[r]] - prefix[displs[r]];
+    slowest  = MAX (slowest, t);
+  }
+
+  if (slowest <= LB_THRESHOLD * total / size)
+    return;
+
+  // New boundaries are the quantiles of the cost distribution, while keeping
+  // at least one row of tiles per process
+  bounds[0]    = 0;
+  bounds[size] = NB_TILES_Y;
+  for (int r = 1, ty = 0; r < size; r++) {
+    double target = total * r / size;
+
+    while (ty < NB_TILES_Y && prefix[ty + 1] < target)
+      ty++;
+    int b = (target - prefix[ty] < prefix[ty + 1] - target) ? ty : ty + 1;
+    b     = MAX (b, bounds[r - 1] + 1);
+    b     = MIN (b, NB_TILES_Y - (size - r));
+    bounds[r] = b;
+  }
+
+  PRINT_DEBUG ('u', "Slabs rebalanced (imbalance: %.2f)\n",
+               slowest * size / total);
+
+  migrate_slabs (bounds);
+}
+
+static unsigned lazy_slab_step (int top, int bot)
+{
+  unsigned change = 0;
+  int ty_first    = top / TILE_H;
+  int ty_last     = bot / TILE_H - 1;
+
+#pragma omp parallel for reduction(| : change) collapse(2) schedule(runtime)
+  for (int y = top; y < bot; y += TILE_H) {
+    for (int x = 0; x < DIM; x += TILE_W) {
+      unsigned tile_y = y / TILE_H;
+      unsigned tile_x = x / TILE_W;
+
+      // Boundary rows depend on ghost rows, which are not tracked
+      if (tile_y == ty_first || tile_y == ty_last ||
+          cur_dirty (tile_y, tile_x) || next_dirty (tile_y, tile_x)) {
+        unsigned local_change = do_tile (x, y, TILE_W, TILE_H);
+        change |= local_change;
+
+#pragma omp atomic
+        tile_row_work[tile_y]++;
+
+        if (local_change) {
+          next_dirty (tile_y - 1, tile_x - 1) = 1;
+          next_dirty (tile_y - 1, tile_x)     = 1;
+          next_dirty (tile_y - 1, tile_x + 1) = 1;
+          next_dirty (tile_y, tile_x - 1)     = 1;
+          next_dirty (tile_y, tile_x)         = 1;
+          next_dirty (tile_y, tile_x + 1)     = 1;
+          next_dirty (tile_y + 1, tile_x - 1) = 1;
+          next_dirty (tile_y + 1, tile_x)     = 1;
+          next_dirty (tile_y + 1, tile_x + 1) = 1;
+        }
+      }
+    }
+  }
+
+  return change;
+}
+
+unsigned life_compute_mpi_lazy_lb (unsigned nb_iter)
+{
+  static unsigned generation = 0;
+  static uint64_t busy       = 0;
+  unsigned res               = 0;
+
+  for (unsigned it = 1; it <= nb_iter; it++) {
+    exchange_halos ();
+
+    uint64_t start  = ezp_gettime ();
+    unsigned change = lazy_slab_step (rankTop (rank), rankBot (rank));
+    busy += ezp_gettime () - start;
+
+    swap_tables_w_dirty ();
+
+    // All processes must agree on when to stop, since rebalancing is a
+    // collective operation
+    MPI_Allreduce (MPI_IN_PLACE, &change, 1, MPI_UNSIGNED, MPI_BOR,
+                   MPI_COMM_WORLD);
+
+    if (++generation % LB_PERIOD == 0) {
+      rebalance_slabs (busy);
+      busy = 0;
+    }
+
+    if (!change) {
+      res = it;
+      break;
+    }
+  }
+
+  return res;
+}
+
+///////////////////////////// Checkpointing
+// MPI variants save/restore their own slab, other variants the whole table
+void life_checkpoint (ezp_ckpt_region_t *r)
+{
+  unsigned top = 0, rows = DIM;
+
+  if (size > 0) {
+    top  = rankTop (rank);
+    rows = rankSize (rank);
+  }
+
+  r->base   = &cur_table (top, 0);
+  r->offset = top * DIM * sizeof (cell_t);
+  r->size   = rows * DIM * sizeof (cell_t);
+  r->total  = DIM * DIM * sizeof (cell_t);
+}
+
 ///////////////////////////// Initial configs
 
 void life_draw_guns (void);
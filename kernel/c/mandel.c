@@ -49,6 +49,91 @@ int mandel_do_tile_default (int x, int y, int width, int height)
   return 0;
 }
 
+///////////////////////////// Mariani-Silver tile version (msilver)
+// Suggested cmdline:
+// ./run -k mandel -v tiled -wt msilver -ts 64
+//
+// The Mandelbrot set (and each of its level sets) is connected: when all
+// pixels on the border of a rectangle share the same iteration count, the
+// interior is filled with it. Otherwise, the rectangle is split in two halves,
+// down to MSILVER_MIN_SIZE pixels.
+
+#define MSILVER_MIN_SIZE 8
+
+static int border_is_uniform (int x, int y, int width, int height)
+{
+  const unsigned v = cur_table (y, x);
+
+  for (int j = x; j < x + width; j++)
+    if (cur_table (y, j) != v || cur_table (y + height - 1, j) != v)
+      return 0;
+
+  for (int i = y + 1; i < y + height - 1; i++)
+    if (cur_table (i, x) != v || cur_table (i, x + width - 1) != v)
+      return 0;
+
+  return 1;
+}
+
+// The border of the rectangle is already computed
+static void msilver_rect (int x, int y, int width, int height)
+{
+  if (border_is_uniform (x, y, width, height)) {
+    const unsigned v = cur_table (y, x);
+
+    for (int i = y + 1; i < y + height - 1; i++)
+      for (int j = x + 1; j < x + width - 1; j++)
+        cur_table (i, j) = v;
+    return;
+  }
+
+  if (width <= MSILVER_MIN_SIZE || height <= MSILVER_MIN_SIZE) {
+    for (int i = y + 1; i < y + height - 1; i++)
+      for (int j = x + 1; j < x + width - 1; j++)
+        cur_table (i, j) = compute_one_pixel (i, j);
+    return;
+  }
+
+  // Compute the line splitting the rectangle along its largest dimension,
+  // which becomes part of the border of both halves
+  if (width >= height) {
+    const int mx = x + width / 2;
+
+    for (int i = y + 1; i < y + height - 1; i++)
+      cur_table (i, mx) = compute_one_pixel (i, mx);
+
+    msilver_rect (x, y, mx - x + 1, height);
+    msilver_rect (mx, y, x + width - mx, height);
+  } else {
+    const int my = y + height / 2;
+
+    for (int j = x + 1; j < x + width - 1; j++)
+      cur_table (my, j) = compute_one_pixel (my, j);
+
+    msilver_rect (x, y, width, my - y + 1);
+    msilver_rect (x, my, width, y + height - my);
+  }
+}
+
+int mandel_do_tile_msilver (int x, int y, int width, int height)
+{
+  if (width < 3 || height < 3)
+    return mandel_do_tile_default (x, y, width, height);
+
+  for (int j = x; j < x + width; j++) {
+    cur_table (y, j)              = compute_one_pixel (y, j);
+    cur_table (y + height - 1, j) = compute_one_pixel (y + height - 1, j);
+  }
+  for (int i = y + 1; i < y + height - 1; i++) {
+    cur_table (i, x)             = compute_one_pixel (i, x);
+    cur_table (i, x + width - 1) = compute_one_pixel (i, x + width - 1);
+  }
+
+  msilver_rect (x, y, width, height);
+
+  return 0;
+}
+
 ///////////////////////////// Simple sequential version (seq)
 // Suggested cmdline:
 // ./run --kernel mandel
@@ -83,6 +168,179 @@ unsigned mandel_compute_tiled (unsigned nb_iter)
   return 0;
 }
 
+///////////////////////////// OpenMP longest-first version (omp_lpt)
+// Suggested cmdline:
+// ./run -k mandel -v omp_lpt -ts 32 --trace
+//
+// From one frame to the next, the view only changes slightly: the number of
+// iterations spent in each tile during the previous frame is a good predictor
+// of its cost. Tiles are dispatched by decreasing predicted cost (Longest
+// Processing Time first) through a shared counter.
+
+static uint64_t *tile_cost = NULL;
+static int *tile_order     = NULL;
+
+void mandel_init_omp_lpt (void)
+{
+  mandel_init ();
+
+  if (tile_cost == NULL) {
+    tile_cost  = calloc (NB_TILES_X * NB_TILES_Y, sizeof (uint64_t));
+    tile_order = malloc (NB_TILES_X * NB_TILES_Y * sizeof (int));
+    // First frame: no prediction yet, raster order
+    for (int t = 0; t < NB_TILES_X * NB_TILES_Y; t++)
+      tile_order[t] = t;
+  }
+}
+
+void mandel_finalize_omp_lpt (void)
+{
+  free (tile_cost);
+  free (tile_order);
+  mandel_finalize ();
+}
+
+static int by_decreasing_cost (const void *a, const void *b)
+{
+  const int ta = *(const int *)a, tb = *(const int *)b;
+
+  if (tile_cost[ta] != tile_cost[tb])
+    return tile_cost[ta] < tile_cost[tb] ? 1 : -1;
+
+  return ta - tb;
+}
+
+unsigned mandel_compute_omp_lpt (unsigned nb_iter)
+{
+  const int nb_tiles = NB_TILES_X * NB_TILES_Y;
+
+  for (unsigned it = 1; it <= nb_iter; it++) {
+    int next = 0;
+
+#pragma omp parallel
+    for (;;) {
+      int k = __atomic_fetch_add (&next, 1, __ATOMIC_RELAXED);
+      if (k >= nb_tiles)
+        break;
+
+      int t = tile_order[k];
+      int x = (t % NB_TILES_X) * TILE_W;
+      int y = (t / NB_TILES_X) * TILE_H;
+      uint64_t cost = 0;
+
+      do_tile (x, y, TILE_W, TILE_H);
+
+      // Prediction for the next frame
+      for (int i = y; i < y + TILE_H; i++)
+        for (int j = x; j < x + TILE_W; j++)
+          cost += cur_table (i, j);
+      tile_cost[t] = cost;
+    }
+
+    qsort (tile_order, nb_tiles, sizeof (int), by_decreasing_cost);
+
+    zoom ();
+  }
+
+  return 0;
+}
+
+///////////////////////////// OpenMP version with temporal reuse (omp_reuse)
+// Suggested cmdline:
+// ./run -k mandel -v omp_reuse -ts 32
+//
+// Consecutive frames only differ by a slight zoom. Each pixel is reprojected
+// into the previous frame: when its neighbourhood there only contains
+// interior points (MAX_ITERATIONS), the pixel is assumed to be interior as
+// well and is not computed. Since this may miss thin filaments, a full frame
+// is computed every REUSE_REFRESH_PERIOD frames.
+
+#define REUSE_REFRESH_PERIOD 16
+
+static unsigned *restrict _prev_table = NULL;
+static unsigned reuse_frame           = 0;
+
+// View of the previous frame
+static float prev_leftX, prev_topY, prev_xstep, prev_ystep;
+
+#define prev_table(y, x) (_prev_table[(y) * DIM + (x)])
+
+void mandel_init_omp_reuse (void)
+{
+  mandel_init ();
+
+  if (_prev_table == NULL)
+    _prev_table = ezp_alloc (DIM * DIM * sizeof (unsigned));
+}
+
+void mandel_finalize_omp_reuse (void)
+{
+  ezp_free (_prev_table, DIM * DIM * sizeof (unsigned));
+  mandel_finalize ();
+}
+
+static int interior_in_prev_frame (int i, int j)
+{
+  float cr = leftX + xstep * j;
+  float ci = topY - ystep * i;
+  int pj   = (int)((cr - prev_leftX) / prev_xstep + 0.5f);
+  int pi   = (int)((prev_topY - ci) / prev_ystep + 0.5f);
+
+  if (pi < 1 || pi >= DIM - 1 || pj < 1 || pj >= DIM - 1)
+    return 0;
+
+  for (int y = pi - 1; y <= pi + 1; y++)
+    for (int x = pj - 1; x <= pj + 1; x++)
+      if (prev_table (y, x) != MAX_ITERATIONS)
+        return 0;
+
+  return 1;
+}
+
+static void reuse_tile (int x, int y, int width, int height)
+{
+  for (int i = y; i < y + height; i++)
+    for (int j = x; j < x + width; j++)
+      cur_table (i, j) = interior_in_prev_frame (i, j)
+                             ? MAX_ITERATIONS
+                             : compute_one_pixel (i, j);
+}
+
+unsigned mandel_compute_omp_reuse (unsigned nb_iter)
+{
+  for (unsigned it = 1; it <= nb_iter; it++) {
+    unsigned *tmp = _prev_table;
+
+    // The previous frame becomes the reference, and is fully overwritten
+    _prev_table = _table;
+    _table      = tmp;
+
+    if (reuse_frame++ % REUSE_REFRESH_PERIOD == 0) {
+#pragma omp parallel for collapse(2) schedule(runtime)
+      for (int y = 0; y < DIM; y += TILE_H)
+        for (int x = 0; x < DIM; x += TILE_W)
+          do_tile (x, y, TILE_W, TILE_H);
+    } else {
+#pragma omp parallel for collapse(2) schedule(runtime)
+      for (int y = 0; y < DIM; y += TILE_H)
+        for (int x = 0; x < DIM; x += TILE_W) {
+          monitoring_start (omp_get_thread_num ());
+          reuse_tile (x, y, TILE_W, TILE_H);
+          monitoring_end_tile (x, y, TILE_W, TILE_H, omp_get_thread_num ());
+        }
+    }
+
+    prev_leftX = leftX;
+    prev_topY  = topY;
+    prev_xstep = xstep;
+    prev_ystep = ystep;
+
+    zoom ();
+  }
+
+  return 0;
+}
+
 /////////////// Mandelbrot basic computation
 
 static unsigned iteration_to_color (unsigned iter)
@@ -261,4 +519,360 @@ int mandel_do_tile_avx (int x, int y, int width, int height)
 
 #endif // AVX
 
+///////////////////////////// Production SIMD tile versions (avx2, avx512)
+// Suggested cmdline:
+// ./run -k mandel -v omp_tiled -wt avx2 -ts 64
+// ./run -k mandel -v omp_tiled -wt avx512 -ts 64
+// (only available when compiled with -mavx2 -mfma / -mavx512f, e.g.
+// -march=native)
+//
+// Lanes stop counting iterations as soon as they diverge, and vectors exit
+// as soon as all lanes diverged.
+// Points inside the main cardioid or the period-2 bulb never diverge: they
+// are given MAX_ITERATIONS without iterating.
+
+#if __AVX2__ == 1 && __FMA__ == 1
+
+static inline __m256 in_cardioid_or_bulb_avx2 (__m256 cr, __m256 ci)
+{
+  const __m256 quarter = _mm256_set1_ps (0.25);
+  __m256 ci2           = _mm256_mul_ps (ci, ci);
+  __m256 xq            = _mm256_sub_ps (cr, quarter);
+  __m256 q             = _mm256_fmadd_ps (xq, xq, ci2);
+  // q * (q + (x - 1/4)) <= y^2 / 4
+  __m256 card = _mm256_cmp_ps (_mm256_mul_ps (q, _mm256_add_ps (q, xq)),
+                               _mm256_mul_ps (quarter, ci2), _CMP_LE_OQ);
+  // (x + 1)^2 + y^2 <= 1/16
+  __m256 xb   = _mm256_add_ps (cr, _mm256_set1_ps (1.0));
+  __m256 bulb = _mm256_cmp_ps (_mm256_fmadd_ps (xb, xb, ci2),
+                               _mm256_set1_ps (0.0625), _CMP_LE_OQ);
+
+  return _mm256_or_ps (card, bulb);
+}
+
+void mandel_tile_check_avx2 (void)
+{
+  // Tile width must be larger than AVX vector size
+  easypap_vec_check (AVX_VEC_SIZE_FLOAT, DIR_HORIZONTAL);
+}
+
+int mandel_do_tile_avx2 (int x, int y, int width, int height)
+{
+  const __m256 two      = _mm256_set1_ps (2.0);
+  const __m256 max_norm = _mm256_set1_ps (4.0);
+  const __m256 lanes    = _mm256_set_ps (7, 6, 5, 4, 3, 2, 1, 0);
+
+  for (int i = y; i < y + height; i++) {
+    const __m256 ci = _mm256_set1_ps (topY - ystep * i);
+
+    for (int j = x; j < x + width; j += AVX_VEC_SIZE_FLOAT) {
+      __m256 cr = _mm256_fmadd_ps (_mm256_add_ps (_mm256_set1_ps (j), lanes),
+                                   _mm256_set1_ps (xstep),
+                                   _mm256_set1_ps (leftX));
+      __m256 inside = in_cardioid_or_bulb_avx2 (cr, ci);
+      // Lanes still iterating (all bits set)
+      __m256 active = _mm256_xor_ps (inside, _mm256_castsi256_ps (
+                                                 _mm256_set1_epi32 (-1)));
+      __m256i iter  = _mm256_and_si256 (_mm256_castps_si256 (inside),
+                                        _mm256_set1_epi32 (MAX_ITERATIONS));
+      __m256 zr = _mm256_setzero_ps (), zi = _mm256_setzero_ps ();
+
+      for (int it = 0; it < MAX_ITERATIONS; it++) {
+        __m256 rc = _mm256_mul_ps (zr, zr);
+        __m256 ic = _mm256_mul_ps (zi, zi);
+
+        active = _mm256_and_ps (
+            active, _mm256_cmp_ps (_mm256_add_ps (rc, ic), max_norm, _CMP_LE_OQ));
+        if (_mm256_movemask_ps (active) == 0)
+          break;
+
+        // active lanes are -1: subtracting them increments the counters
+        iter = _mm256_sub_epi32 (iter, _mm256_castps_si256 (active));
+
+        __m256 xy = _mm256_mul_ps (zr, zi);
+        zr        = _mm256_add_ps (rc, _mm256_sub_ps (cr, ic));
+        zi        = _mm256_fmadd_ps (two, xy, ci);
+      }
+
+      _mm256_storeu_si256 ((__m256i *)&cur_table (i, j), iter);
+    }
+  }
+
+  return 0;
+}
+
+#endif // AVX2
+
+#if __AVX512F__ == 1
+
+static inline __mmask16 in_cardioid_or_bulb_avx512 (__m512 cr, __m512 ci)
+{
+  const __m512 quarter = _mm512_set1_ps (0.25);
+  __m512 ci2           = _mm512_mul_ps (ci, ci);
+  __m512 xq            = _mm512_sub_ps (cr, quarter);
+  __m512 q             = _mm512_fmadd_ps (xq, xq, ci2);
+  __m512 xb            = _mm512_add_ps (cr, _mm512_set1_ps (1.0));
+
+  return _mm512_cmp_ps_mask (_mm512_mul_ps (q, _mm512_add_ps (q, xq)),
+                             _mm512_mul_ps (quarter, ci2), _CMP_LE_OQ) |
+         _mm512_cmp_ps_mask (_mm512_fmadd_ps (xb, xb, ci2),
+                             _mm512_set1_ps (0.0625), _CMP_LE_OQ);
+}
+
+void mandel_tile_check_avx512 (void)
+{
+  // Tile width must be larger than AVX-512 vector size
+  easypap_vec_check (AVX512_VEC_SIZE_FLOAT, DIR_HORIZONTAL);
+}
+
+int mandel_do_tile_avx512 (int x, int y, int width, int height)
+{
+  const __m512 two      = _mm512_set1_ps (2.0);
+  const __m512 max_norm = _mm512_set1_ps (4.0);
+  const __m512i one     = _mm512_set1_epi32 (1);
+  const __m512 lanes    = _mm512_set_ps (15, 14, 13, 12, 11, 10, 9, 8, 7, 6,
+                                         5, 4, 3, 2, 1, 0);
+
+  for (int i = y; i < y + height; i++) {
+    const __m512 ci = _mm512_set1_ps (topY - ystep * i);
+
+    for (int j = x; j < x + width; j += AVX512_VEC_SIZE_FLOAT) {
+      __m512 cr = _mm512_fmadd_ps (_mm512_add_ps (_mm512_set1_ps (j), lanes),
+                                   _mm512_set1_ps (xstep),
+                                   _mm512_set1_ps (leftX));
+      __mmask16 inside = in_cardioid_or_bulb_avx512 (cr, ci);
+      __mmask16 active = ~inside;
+      __m512i iter     = _mm512_maskz_mov_epi32 (
+          inside, _mm512_set1_epi32 (MAX_ITERATIONS));
+      __m512 zr = _mm512_setzero_ps (), zi = _mm512_setzero_ps ();
+
+      for (int it = 0; it < MAX_ITERATIONS; it++) {
+        __m512 rc = _mm512_mul_ps (zr, zr);
+        __m512 ic = _mm512_mul_ps (zi, zi);
+
+        active = _mm512_mask_cmp_ps_mask (active, _mm512_add_ps (rc, ic),
+                                          max_norm, _CMP_LE_OQ);
+        if (active == 0)
+          break;
+
+        iter = _mm512_mask_add_epi32 (iter, active, iter, one);
+
+        __m512 xy = _mm512_mul_ps (zr, zi);
+        zr        = _mm512_add_ps (rc, _mm512_sub_ps (cr, ic));
+        zi        = _mm512_fmadd_ps (two, xy, ci);
+      }
+
+      _mm512_storeu_si512 (&cur_table (i, j), iter);
+    }
+  }
+
+  return 0;
+}
+
+#endif // AVX512
+
+#endif
+
+///////////////////////////// Deep zoom with perturbation (perturb)
+// Suggested cmdline:
+// ./run -k mandel -v perturb -ts 32
+//
+// Float coordinates cannot tell neighbouring pixels apart after a few hundred
+// zoom steps. Here, the view is kept in long double and only one reference
+// orbit Z(n), at the centre of the view, is computed in long double per
+// frame. Each pixel c = C + dc then iterates the (double precision) offset
+// dz(n) = z(n) - Z(n) of its own orbit:
+//   dz(n+1) = (2 Z(n) + dz(n)) dz(n) + dc
+// When |z(n)| < |dz(n)|, the offset no longer faithfully represents z (this is
+// the source of "glitches"): the pixel is rebased on the start of the
+// reference orbit (dz = z, n = 0), which is also done when it outlives the
+// reference orbit.
+
+static long double pt_centerX, pt_centerY;
+static long double pt_width, pt_height;
+
+static double ref_r[MAX_ITERATIONS + 1];
+static double ref_i[MAX_ITERATIONS + 1];
+static int ref_len; // number of valid points in reference orbit
+
+void mandel_init_perturb (void)
+{
+  mandel_init ();
+
+  pt_centerX = ((long double)leftX + (long double)rightX) / 2;
+  pt_centerY = ((long double)topY + (long double)bottomY) / 2;
+  pt_width   = (long double)rightX - (long double)leftX;
+  pt_height  = (long double)topY - (long double)bottomY;
+}
+
+static void perturb_zoom (void)
+{
+  // Same behaviour as zoom (), without moving the centre
+  pt_width *= 1 - 2 * ZOOM_SPEED;
+  pt_height *= 1 - 2 * ZOOM_SPEED;
+}
+
+static void compute_reference_orbit (void)
+{
+  long double zr = 0.0, zi = 0.0;
+
+  ref_r[0] = ref_i[0] = 0.0;
+  for (ref_len = 1; ref_len <= MAX_ITERATIONS; ref_len++) {
+    long double x2 = zr * zr;
+    long double y2 = zi * zi;
+
+    if (x2 + y2 > 4.0)
+      break;
+
+    zi = 2 * zr * zi + pt_centerY;
+    zr = x2 - y2 + pt_centerX;
+
+    ref_r[ref_len] = zr;
+    ref_i[ref_len] = zi;
+  }
+  if (ref_len > MAX_ITERATIONS)
+    ref_len = MAX_ITERATIONS + 1;
+}
+
+static unsigned perturb_one_pixel (double dcr, double dci)
+{
+  double dzr = 0.0, dzi = 0.0;
+  int n = 0;
+  unsigned iter;
+
+  for (iter = 0; iter < MAX_ITERATIONS; iter++) {
+    double zr   = ref_r[n] + dzr;
+    double zi   = ref_i[n] + dzi;
+    double norm = zr * zr + zi * zi;
+
+    if (norm > 4.0)
+      break;
+
+    if (norm < dzr * dzr + dzi * dzi || n == ref_len - 1) {
+      dzr = zr;
+      dzi = zi;
+      n   = 0;
+    }
+
+    double tr = 2 * ref_r[n] + dzr;
+    double ti = 2 * ref_i[n] + dzi;
+    double nr = tr * dzr - ti * dzi + dcr;
+
+    dzi = tr * dzi + ti * dzr + dci;
+    dzr = nr;
+    n++;
+  }
+
+  return iter;
+}
+
+static inline double perturb_dcr (int j)
+{
+  return (double)(pt_width / DIM) * (j - DIM / 2);
+}
+
+static void perturb_row_scalar (int i, int x, int width, double dci)
+{
+  for (int j = x; j < x + width; j++)
+    cur_table (i, j) = perturb_one_pixel (perturb_dcr (j), dci);
+}
+
+#if defined(ENABLE_VECTO) && __AVX2__ == 1 && __FMA__ == 1
+
+// 4 pixels at once: after rebasing, lanes use different positions in the
+// reference orbit, which are gathered
+static void perturb_row (int i, int x, int width, double dci_s)
+{
+  const __m256d four   = _mm256_set1_pd (4.0);
+  const __m256d two    = _mm256_set1_pd (2.0);
+  const __m256d zero   = _mm256_setzero_pd ();
+  const __m256i last   = _mm256_set1_epi64x (ref_len - 1);
+  const __m256d dci    = _mm256_set1_pd (dci_s);
+  const double step    = (double)(pt_width / DIM);
+  int j                = x;
+
+  for (; j + 4 <= x + width; j += 4) {
+    __m256d dcr = _mm256_mul_pd (
+        _mm256_set1_pd (step),
+        _mm256_set_pd (j + 3 - DIM / 2, j + 2 - DIM / 2, j + 1 - DIM / 2,
+                       j - DIM / 2));
+    __m256d dzr = zero, dzi = zero;
+    __m256i n = _mm256_setzero_si256 (), iter = _mm256_setzero_si256 ();
+    __m256d active = _mm256_castsi256_pd (_mm256_set1_epi64x (-1));
+
+    for (int it = 0; it < MAX_ITERATIONS; it++) {
+      __m256d Zr   = _mm256_i64gather_pd (ref_r, n, 8);
+      __m256d Zi   = _mm256_i64gather_pd (ref_i, n, 8);
+      __m256d zr   = _mm256_add_pd (Zr, dzr);
+      __m256d zi   = _mm256_add_pd (Zi, dzi);
+      __m256d norm = _mm256_fmadd_pd (zr, zr, _mm256_mul_pd (zi, zi));
+
+      active = _mm256_and_pd (active, _mm256_cmp_pd (norm, four, _CMP_LE_OQ));
+      if (_mm256_movemask_pd (active) == 0)
+        break;
+
+      // Active lanes are -1: counters and orbit positions of diverged lanes
+      // are frozen
+      iter = _mm256_sub_epi64 (iter, _mm256_castpd_si256 (active));
+
+      __m256d rebase = _mm256_or_pd (
+          _mm256_cmp_pd (norm,
+                         _mm256_fmadd_pd (dzr, dzr, _mm256_mul_pd (dzi, dzi)),
+                         _CMP_LT_OQ),
+          _mm256_castsi256_pd (_mm256_cmpeq_epi64 (n, last)));
+
+      dzr = _mm256_blendv_pd (dzr, zr, rebase);
+      dzi = _mm256_blendv_pd (dzi, zi, rebase);
+      Zr  = _mm256_blendv_pd (Zr, zero, rebase);
+      Zi  = _mm256_blendv_pd (Zi, zero, rebase);
+      n   = _mm256_andnot_si256 (_mm256_castpd_si256 (rebase), n);
+
+      __m256d tr = _mm256_fmadd_pd (two, Zr, dzr);
+      __m256d ti = _mm256_fmadd_pd (two, Zi, dzi);
+      __m256d nr = _mm256_fmsub_pd (tr, dzr, _mm256_fmsub_pd (ti, dzi, dcr));
+
+      dzi = _mm256_fmadd_pd (tr, dzi, _mm256_fmadd_pd (ti, dzr, dci));
+      dzr = nr;
+      n   = _mm256_sub_epi64 (n, _mm256_castpd_si256 (active));
+    }
+
+    long long res[4];
+    _mm256_storeu_si256 ((__m256i *)res, iter);
+    for (int k = 0; k < 4; k++)
+      cur_table (i, j + k) = res[k];
+  }
+
+  perturb_row_scalar (i, j, x + width - j, dci_s);
+}
+
+#else
+
+#define perturb_row perturb_row_scalar
+
 #endif
+
+static void perturb_tile (int x, int y, int width, int height)
+{
+  for (int i = y; i < y + height; i++)
+    perturb_row (i, x, width, (double)(pt_height / DIM) * (DIM / 2 - i));
+}
+
+unsigned mandel_compute_perturb (unsigned nb_iter)
+{
+  for (unsigned it = 1; it <= nb_iter; it++) {
+
+    compute_reference_orbit ();
+
+#pragma omp parallel for collapse(2) schedule(runtime)
+    for (int y = 0; y < DIM; y += TILE_H)
+      for (int x = 0; x < DIM; x += TILE_W) {
+        monitoring_start (omp_get_thread_num ());
+        perturb_tile (x, y, TILE_W, TILE_H);
+        monitoring_end_tile (x, y, TILE_W, TILE_H, omp_get_thread_num ());
+      }
+
+    perturb_zoom ();
+  }
+
+  return 0;
+}
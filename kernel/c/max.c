@@ -10,11 +10,15 @@
 enum
 {
   TASKID_DOWN_RIGHT,
-  TASKID_UP_LEFT
+  TASKID_UP_LEFT,
+  TASKID_LABEL,
+  TASKID_MERGE,
+  TASKID_REDUCE
 };
 
 static char *task_ids[] = {"Down Right Propagation", "Up Left Propagation",
-                           NULL};
+                           "Local Labelling", "Border Merge",
+                           "Component Max", NULL};
 
 void max_init (void)
 {
@@ -146,6 +150,275 @@ unsigned max_compute_tiled (unsigned nb_iter)
   return res;
 }
 
+///////////////////////////// OpenMP task version (omp_task)
+// Suggested cmdline(s):
+// ./run -l data/img/spirale.png -k max -v omp_task -ts 32 --trace
+//
+// A tile of the down-right sweep needs its top and left neighbours to be
+// processed first (and the up-left sweep mirrors this): tasks are chained
+// with dependencies, which forms a wavefront. Both sweeps of an iteration
+// belong to the same task graph, so the up-left wavefront starts as soon as
+// the bottom-right tiles are done.
+//
+// Lazy evaluation: each tile records the sweep during which it last changed
+// (stamp) and the sweep during which it was last propagated in each direction
+// (seen_*). A tile is only propagated again if itself or one of the
+// neighbours it reads from changed since then.
+
+static int *stamp   = NULL;
+static int *seen_dr = NULL;
+static int *seen_ul = NULL;
+static int sweep    = 0;
+
+// Arrays are bordered: border tiles have neighbours that never change
+#define tile_info(t, i, j) ((t)[((i) + 1) * (NB_TILES_X + 2) + (j) + 1])
+
+void max_init_omp_task (void)
+{
+  const int size = (NB_TILES_X + 2) * (NB_TILES_Y + 2);
+
+  max_init ();
+
+  stamp   = malloc (size * sizeof (int));
+  seen_dr = malloc (size * sizeof (int));
+  seen_ul = malloc (size * sizeof (int));
+
+  for (int k = 0; k < size; k++)
+    stamp[k] = seen_dr[k] = seen_ul[k] = -1;
+  // Every tile has to be propagated at least once
+  for (int i = 0; i < NB_TILES_Y; i++)
+    for (int j = 0; j < NB_TILES_X; j++)
+      tile_info (stamp, i, j) = 0;
+}
+
+void max_finalize_omp_task (void)
+{
+  free (stamp);
+  free (seen_dr);
+  free (seen_ul);
+}
+
+unsigned max_compute_omp_task (unsigned nb_iter)
+{
+  unsigned res = 0;
+
+  for (unsigned it = 1; it <= nb_iter; it++) {
+    int change     = 0;
+    const int s_dr = ++sweep;
+    const int s_ul = ++sweep;
+
+#pragma omp parallel
+#pragma omp single
+    {
+      // Down-right propagation
+      for (int i = 0; i < NB_TILES_Y; i++)
+        for (int j = 0; j < NB_TILES_X; j++)
+#pragma omp task firstprivate(i, j)                                           \
+    depend(in : tile_info (stamp, i - 1, j), tile_info (stamp, i, j - 1))      \
+    depend(inout : tile_info (stamp, i, j))
+        {
+          const int last = tile_info (seen_dr, i, j);
+
+          if (tile_info (stamp, i, j) > last ||
+              tile_info (stamp, i - 1, j) > last ||
+              tile_info (stamp, i, j - 1) > last) {
+            tile_info (seen_dr, i, j) = s_dr;
+            if (tile_down_right (j * TILE_W, i * TILE_H, TILE_W, TILE_H)) {
+              tile_info (stamp, i, j) = s_dr;
+              __atomic_store_n (&change, 1, __ATOMIC_RELAXED);
+            }
+          }
+        }
+
+      // Up-left propagation
+      for (int i = NB_TILES_Y - 1; i >= 0; i--)
+        for (int j = NB_TILES_X - 1; j >= 0; j--)
+#pragma omp task firstprivate(i, j)                                           \
+    depend(in : tile_info (stamp, i + 1, j), tile_info (stamp, i, j + 1))      \
+    depend(inout : tile_info (stamp, i, j))
+        {
+          const int last = tile_info (seen_ul, i, j);
+
+          if (tile_info (stamp, i, j) > last ||
+              tile_info (stamp, i + 1, j) > last ||
+              tile_info (stamp, i, j + 1) > last) {
+            tile_info (seen_ul, i, j) = s_ul;
+            if (tile_up_left (j * TILE_W, i * TILE_H, TILE_W, TILE_H)) {
+              tile_info (stamp, i, j) = s_ul;
+              __atomic_store_n (&change, 1, __ATOMIC_RELAXED);
+            }
+          }
+        }
+    }
+
+    if (!change) {
+      res = it;
+      break;
+    }
+  }
+
+  return res;
+}
+
+///////////////////////////// Union-find version (unionfind)
+// Suggested cmdline(s):
+// ./run -l data/img/spirale.png -k max -v unionfind -ts 32
+//
+// Each connected (4-neighbourhood) region of non-zero pixels ends up filled
+// with its maximum: regions are labelled once with a union-find structure,
+// instead of propagating maxima over as many sweeps as the longest path
+// requires.
+//  1. each tile labels its own pixels (no concurrent access);
+//  2. regions spanning several tiles are merged along the top and left
+//     borders of each tile, using a lock-free union (the root with the
+//     largest index is linked to the other one with a CAS);
+//  3. the maximum of each region is reduced on its root, and written back.
+
+static int *parent      = NULL; // -1 for background pixels
+static uint32_t *uf_max = NULL; // maximum of each region (on its root)
+
+#define uf_index(i, j) ((i) * DIM + (j))
+
+void max_init_unionfind (void)
+{
+  max_init ();
+
+  parent = malloc (DIM * DIM * sizeof (int));
+  uf_max = malloc (DIM * DIM * sizeof (uint32_t));
+}
+
+void max_finalize_unionfind (void)
+{
+  free (parent);
+  free (uf_max);
+}
+
+static int uf_find (int p)
+{
+  int q = __atomic_load_n (&parent[p], __ATOMIC_RELAXED);
+
+  while (q != p) {
+    // Path halving: any ancestor is a valid parent
+    int r = __atomic_load_n (&parent[q], __ATOMIC_RELAXED);
+    __atomic_store_n (&parent[p], r, __ATOMIC_RELAXED);
+    p = q;
+    q = r;
+  }
+
+  return p;
+}
+
+static void uf_union (int a, int b)
+{
+  for (;;) {
+    int ra = uf_find (a);
+    int rb = uf_find (b);
+
+    if (ra == rb)
+      return;
+    if (ra < rb) {
+      int tmp = ra;
+      ra      = rb;
+      rb      = tmp;
+    }
+    // Fails if ra is no longer a root: try again
+    if (__atomic_compare_exchange_n (&parent[ra], &ra, rb, 0, __ATOMIC_RELAXED,
+                                     __ATOMIC_RELAXED))
+      return;
+  }
+}
+
+static void tile_label_cpu (int x, int y, int w, int h, int cpu)
+{
+  monitoring_start (cpu);
+
+  for (int i = y; i < y + h; i++)
+    for (int j = x; j < x + w; j++)
+      if (cur_img (i, j)) {
+        int p     = uf_index (i, j);
+        parent[p] = p;
+        if (i > y && cur_img (i - 1, j))
+          uf_union (p, uf_index (i - 1, j));
+        if (j > x && cur_img (i, j - 1))
+          uf_union (p, uf_index (i, j - 1));
+      } else
+        parent[uf_index (i, j)] = -1;
+
+  monitoring_end_tile_id (x, y, w, h, cpu, TASKID_LABEL);
+}
+
+static void tile_merge_cpu (int x, int y, int w, int h, int cpu)
+{
+  monitoring_start (cpu);
+
+  if (y > 0)
+    for (int j = x; j < x + w; j++)
+      if (cur_img (y, j) && cur_img (y - 1, j))
+        uf_union (uf_index (y, j), uf_index (y - 1, j));
+
+  if (x > 0)
+    for (int i = y; i < y + h; i++)
+      if (cur_img (i, x) && cur_img (i, x - 1))
+        uf_union (uf_index (i, x), uf_index (i, x - 1));
+
+  monitoring_end_tile_id (x, y, w, h, cpu, TASKID_MERGE);
+}
+
+static void tile_reduce_cpu (int x, int y, int w, int h, int cpu)
+{
+  monitoring_start (cpu);
+
+  for (int i = y; i < y + h; i++)
+    for (int j = x; j < x + w; j++)
+      if (cur_img (i, j)) {
+        int r      = uf_find (uf_index (i, j));
+        uint32_t v = cur_img (i, j);
+        uint32_t m = __atomic_load_n (&uf_max[r], __ATOMIC_RELAXED);
+
+        while (v > m && !__atomic_compare_exchange_n (&uf_max[r], &m, v, 0,
+                                                      __ATOMIC_RELAXED,
+                                                      __ATOMIC_RELAXED))
+          ;
+      }
+
+  monitoring_end_tile_id (x, y, w, h, cpu, TASKID_REDUCE);
+}
+
+unsigned max_compute_unionfind (unsigned nb_iter)
+{
+#pragma omp parallel
+  {
+    const int cpu = omp_get_thread_num ();
+
+#pragma omp for collapse(2) schedule(runtime)
+    for (int i = 0; i < NB_TILES_Y; i++)
+      for (int j = 0; j < NB_TILES_X; j++)
+        tile_label_cpu (j * TILE_W, i * TILE_H, TILE_W, TILE_H, cpu);
+
+#pragma omp for collapse(2) schedule(runtime)
+    for (int i = 0; i < NB_TILES_Y; i++)
+      for (int j = 0; j < NB_TILES_X; j++)
+        tile_merge_cpu (j * TILE_W, i * TILE_H, TILE_W, TILE_H, cpu);
+
+#pragma omp for schedule(static)
+    for (int p = 0; p < DIM * DIM; p++)
+      uf_max[p] = 0;
+
+#pragma omp for collapse(2) schedule(runtime)
+    for (int i = 0; i < NB_TILES_Y; i++)
+      for (int j = 0; j < NB_TILES_X; j++)
+        tile_reduce_cpu (j * TILE_W, i * TILE_H, TILE_W, TILE_H, cpu);
+
+#pragma omp for schedule(static)
+    for (int p = 0; p < DIM * DIM; p++)
+      if (parent[p] != -1)
+        image[p] = uf_max[uf_find (p)];
+  }
+
+  // The image is stable after a single pass
+  return 1;
+}
+
 ///////////////////////////// Drawing functions
 
 static void spiral (unsigned twists);
@@ -1,11 +1,26 @@
 #include "easypap.h"
 
+#include <limits.h>
+#include <numa.h>
 #include <omp.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
+// Uncomment to store synchronous sandpile cells on 8 bits. Once the initial
+// transient is over, almost every cell holds less than 8 grains: narrow cells
+// divide memory traffic by 4. The rare cells holding more than 254 grains
+// contain SAND_ESCAPE and their real value is kept in an overflow hash table.
+// #define SANDPILE_U8
+
+#ifdef SANDPILE_U8
+typedef uint8_t TYPE;
+#define SAND_ESCAPE 255U
+#else
 typedef unsigned int TYPE;
+#endif
 
 static TYPE *TABLE = NULL;
 
@@ -33,31 +48,247 @@ static inline void swap_tables()
   out = tmp;
 }
 
-static TYPE max_grains;
+#ifdef SANDPILE_U8
+
+// One open-addressing hash table (key = y * DIM + x) per step. During an
+// iteration, the 'in' table is only read and the 'out' table is only written,
+// so lookups never race with insertions (which are serialized).
+typedef struct
+{
+  unsigned *keys; // UINT_MAX = empty slot
+  unsigned *values;
+  unsigned capacity; // power of 2
+  unsigned count;
+} overflow_t;
+
+static overflow_t overflow[2];
+
+static void overflow_alloc(overflow_t *o, unsigned capacity)
+{
+  o->keys     = malloc(capacity * sizeof(unsigned));
+  o->values   = malloc(capacity * sizeof(unsigned));
+  o->capacity = capacity;
+  o->count    = 0;
+  memset(o->keys, 0xFF, capacity * sizeof(unsigned));
+}
+
+static void overflow_free(overflow_t *o)
+{
+  free(o->keys);
+  free(o->values);
+  o->keys = o->values = NULL;
+}
+
+static inline unsigned overflow_slot(const overflow_t *o, unsigned key)
+{
+  unsigned h = (key * 2654435761U) & (o->capacity - 1);
+
+  while (o->keys[h] != UINT_MAX && o->keys[h] != key)
+    h = (h + 1) & (o->capacity - 1);
+
+  return h;
+}
+
+static void overflow_insert(overflow_t *o, unsigned key, unsigned value)
+{
+  // Entries are never removed: an entry is only meaningful while its cell
+  // holds SAND_ESCAPE, and is refreshed each time the cell overflows again
+  if (2 * (o->count + 1) > o->capacity)
+  {
+    overflow_t bigger;
+
+    overflow_alloc(&bigger, 2 * o->capacity);
+    for (unsigned i = 0; i < o->capacity; i++)
+      if (o->keys[i] != UINT_MAX)
+        overflow_insert(&bigger, o->keys[i], o->values[i]);
+    overflow_free(o);
+    *o = bigger;
+  }
+
+  unsigned h = overflow_slot(o, key);
+
+  if (o->keys[h] == UINT_MAX)
+  {
+    o->keys[h] = key;
+    o->count++;
+  }
+  o->values[h] = value;
+}
+
+static inline unsigned get_grains(int step, int y, int x)
+{
+  unsigned v = table(step, y, x);
+
+  if (v == SAND_ESCAPE)
+  {
+    unsigned h = overflow_slot(&overflow[step], y * DIM + x);
+
+    // Overflowed cells are not part of checkpoints
+    if (overflow[step].keys[h] != UINT_MAX)
+      v = overflow[step].values[h];
+  }
+
+  return v;
+}
+
+static inline void set_grains(int step, int y, int x, unsigned v)
+{
+  if (v >= SAND_ESCAPE)
+  {
+#pragma omp critical(sand_overflow)
+    overflow_insert(&overflow[step], y * DIM + x, v);
+    v = SAND_ESCAPE;
+  }
+  table(step, y, x) = v;
+}
+
+#else
+
+static inline unsigned get_grains(int step, int y, int x)
+{
+  return table(step, y, x);
+}
+
+static inline void set_grains(int step, int y, int x, unsigned v)
+{
+  table(step, y, x) = v;
+}
+
+#endif
+
+static unsigned max_grains;
+
+/////////////////////////////  NUMA placement
+
+// By default, table pages are placed by the first-touch policy (see -ft and
+// the ${kernel}_ft hooks). EASYPAP_NUMA=interleave spreads them round-robin
+// over all NUMA nodes instead.
+static int numa_interleave = -1;
+
+static int use_numa_interleave(void)
+{
+  if (numa_interleave == -1)
+  {
+    char *env = getenv("EASYPAP_NUMA");
+
+    numa_interleave = 0;
+    if (env != NULL && !strcmp(env, "interleave"))
+    {
+      if (numa_available() == -1)
+        PRINT_DEBUG('u', "NUMA not available: EASYPAP_NUMA ignored\n");
+      else
+        numa_interleave = 1;
+    }
+  }
+  return numa_interleave;
+}
+
+/////////////////////////////  Incremental refresh
+
+// Tiles modified since the last refresh, and maximum number of grains of
+// each tile as seen by the last refresh. Only dirty tiles are re-coloured.
+static char *tile_dirty   = NULL;
+static unsigned *tile_max = NULL;
+
+#define tile_info(t, ty, tx) ((t)[(ty) * NB_TILES_X + (tx)])
+
+// Colours of cells holding less than 256 grains, for a given max_grains
+static uint32_t colour_lut[256];
+static unsigned lut_max;
+
+static void tile_info_alloc(void)
+{
+  tile_dirty = malloc(NB_TILES_X * NB_TILES_Y);
+  tile_max   = calloc(NB_TILES_X * NB_TILES_Y, sizeof(unsigned));
+  memset(tile_dirty, 1, NB_TILES_X * NB_TILES_Y);
+  lut_max = UINT_MAX;
+}
+
+static void tile_info_free(void)
+{
+  free(tile_dirty);
+  free(tile_max);
+  tile_dirty = NULL;
+  tile_max   = NULL;
+}
+
+static void mark_all_dirty(void)
+{
+  memset(tile_dirty, 1, NB_TILES_X * NB_TILES_Y);
+}
+
+// Mark tiles overlapping area [x, x + width[ x [y, y + height[ (which may
+// spread over several tiles or be one cell larger than a tile)
+static inline void mark_dirty_area(int x, int y, int width, int height)
+{
+  int x0 = x < 0 ? 0 : x, x1 = x + width > DIM ? DIM : x + width;
+  int y0 = y < 0 ? 0 : y, y1 = y + height > DIM ? DIM : y + height;
+
+  for (int ty = y0 / TILE_H; ty <= (y1 - 1) / TILE_H; ty++)
+    for (int tx = x0 / TILE_W; tx <= (x1 - 1) / TILE_W; tx++)
+      tile_info(tile_dirty, ty, tx) = 1;
+}
+
+static inline uint32_t grain_colour(unsigned g)
+{
+  int r, v, b;
+  r = v = b = 0;
+  if (g == 1)
+    v = 255;
+  else if (g == 2)
+    b = 255;
+  else if (g == 3)
+    r = 255;
+  else if (g == 4)
+    r = v = b = 255;
+  else if (g > 4)
+    r = b = 255 - (240 * ((double)g) / (double)max_grains);
+
+  return ezv_rgb(r, v, b);
+}
 
 void asandPile_refresh_img()
 {
-  unsigned long int max = 0;
-  for (int i = 1; i < DIM - 1; i++)
-    for (int j = 1; j < DIM - 1; j++)
+  unsigned max = 0;
+
+  // Colours depend on max_grains: when it changes, every tile is re-coloured
+  if (lut_max != max_grains)
+  {
+    for (unsigned g = 0; g < 256; g++)
+      colour_lut[g] = grain_colour(g);
+    lut_max = max_grains;
+    mark_all_dirty();
+  }
+
+  for (int ty = 0; ty < NB_TILES_Y; ty++)
+    for (int tx = 0; tx < NB_TILES_X; tx++)
     {
-      int g = table(in, i, j);
-      int r, v, b;
-      r = v = b = 0;
-      if (g == 1)
-        v = 255;
-      else if (g == 2)
-        b = 255;
-      else if (g == 3)
-        r = 255;
-      else if (g == 4)
-        r = v = b = 255;
-      else if (g > 4)
-        r = b = 255 - (240 * ((double)g) / (double)max_grains);
-
-      cur_img (i, j) = ezv_rgb (r, v, b);
-      if (g > max)
-        max = g;
+      if (tile_info(tile_dirty, ty, tx))
+      {
+        int y0 = ty * TILE_H, y1 = y0 + TILE_H;
+        int x0 = tx * TILE_W, x1 = x0 + TILE_W;
+        unsigned tmax = 0;
+
+        // Outer border cells are sinks and are not displayed
+        y0 += (y0 == 0);
+        x0 += (x0 == 0);
+        y1 -= (y1 == DIM);
+        x1 -= (x1 == DIM);
+
+        for (int i = y0; i < y1; i++)
+          for (int j = x0; j < x1; j++)
+          {
+            unsigned g = get_grains(in, i, j);
+
+            cur_img (i, j) = g < 256 ? colour_lut[g] : grain_colour(g);
+            if (g > tmax)
+              tmax = g;
+          }
+        tile_info(tile_max, ty, tx)   = tmax;
+        tile_info(tile_dirty, ty, tx) = 0;
+      }
+      if (tile_info(tile_max, ty, tx) > max)
+        max = tile_info(tile_max, ty, tx);
     }
   max_grains = max;
 }
@@ -66,7 +297,7 @@ void asandPile_refresh_img()
 
 static inline void set_cell (int y, int x, unsigned v)
 {
-  atable (y, x) = v;
+  set_grains (0, y, x, v);
   if (gpu_used)
     cur_img (y, x) = v;
 }
@@ -182,12 +413,52 @@ ALIAS(draw_spirals);
 
 void ssandPile_init()
 {
-  TABLE = calloc(2 * DIM * DIM, sizeof(TYPE));
+  if (use_numa_interleave())
+    // Pages are zero-filled
+    TABLE = numa_alloc_interleaved(2 * DIM * DIM * sizeof(TYPE));
+  else
+    TABLE = calloc(2 * DIM * DIM, sizeof(TYPE));
+  tile_info_alloc();
+#ifdef SANDPILE_U8
+  // Overflowed cells live in the hash table, which is not checkpointed
+  if (checkpoint_period || restart_file != NULL)
+    exit_with_error("Checkpoints need 32-bit cells (undefine SANDPILE_U8)");
+  overflow_alloc(&overflow[0], 1024);
+  overflow_alloc(&overflow[1], 1024);
+#endif
 }
 
 void ssandPile_finalize()
 {
-  free(TABLE);
+  if (use_numa_interleave())
+    numa_free(TABLE, 2 * DIM * DIM * sizeof(TYPE));
+  else
+    free(TABLE);
+  tile_info_free();
+#ifdef SANDPILE_U8
+  overflow_free(&overflow[0]);
+  overflow_free(&overflow[1]);
+#endif
+}
+
+// Tiles are touched by the same threads as in the omp/lazy compute loops
+void ssandPile_ft()
+{
+#pragma omp parallel for collapse(2) schedule(runtime)
+  for (int y = 0; y < DIM; y += TILE_H)
+    for (int x = 0; x < DIM; x += TILE_W)
+      for (int i = y; i < y + TILE_H; i++)
+        for (int j = x; j < x + TILE_W; j++)
+          table(0, i, j) = table(1, i, j) = 0;
+}
+
+// Only the current table is saved: the other one is fully overwritten by the
+// next iteration.
+void ssandPile_checkpoint (ezp_ckpt_region_t *r)
+{
+  r->base   = &table (in, 0, 0);
+  r->offset = 0;
+  r->size   = r->total = DIM * DIM * sizeof (TYPE);
 }
 
 int ssandPile_do_tile_default(int x, int y, int width, int height)
@@ -197,15 +468,19 @@ int ssandPile_do_tile_default(int x, int y, int width, int height)
   for (int i = y; i < y + height; i++)
     for (int j = x; j < x + width; j++)
     {
-      table(out, i, j) = table(in, i, j) % 4;
-      table(out, i, j) += table(in, i + 1, j) / 4;
-      table(out, i, j) += table(in, i - 1, j) / 4;
-      table(out, i, j) += table(in, i, j + 1) / 4;
-      table(out, i, j) += table(in, i, j - 1) / 4;
-      if (table(out, i, j) != table(in, i, j))
+      unsigned v = get_grains(in, i, j) % 4;
+      v += get_grains(in, i + 1, j) / 4;
+      v += get_grains(in, i - 1, j) / 4;
+      v += get_grains(in, i, j + 1) / 4;
+      v += get_grains(in, i, j - 1) / 4;
+      set_grains(out, i, j, v);
+      if (v != get_grains(in, i, j))
         diff = 1;
     }
 
+  if (diff)
+    mark_dirty_area(x, y, width, height);
+
   return diff;
 }
 
@@ -242,6 +517,246 @@ unsigned ssandPile_compute_tiled(unsigned nb_iter)
   return 0;
 }
 
+///////////////////////////// OpenMP version (omp)
+
+unsigned ssandPile_compute_omp(unsigned nb_iter)
+{
+  for (unsigned it = 1; it <= nb_iter; it++)
+  {
+    int change = 0;
+
+#pragma omp parallel for collapse(2) schedule(runtime) reduction(| : change)
+    for (int y = 0; y < DIM; y += TILE_H)
+      for (int x = 0; x < DIM; x += TILE_W)
+        change |=
+            do_tile(x + (x == 0), y + (y == 0),
+                    TILE_W - ((x + TILE_W == DIM) + (x == 0)),
+                    TILE_H - ((y + TILE_H == DIM) + (y == 0)));
+    swap_tables();
+    if (change == 0)
+      return it;
+  }
+
+  return 0;
+}
+
+///////////////////////////// Lazy OpenMP version (lazy)
+// Suggested cmdline:
+// ./run -k ssandPile -v lazy -a 4partout -s 4096 -ts 64 -n
+
+// Per-tile change flags of the previous/current iteration. Arrays are
+// bordered, so that neighbours of border tiles can be read without checks.
+static char *_changed_tiles     = NULL;
+static char *_changed_tiles_alt = NULL;
+
+static inline char *changed_cell(char *restrict t, int ty, int tx)
+{
+  return t + (ty + 1) * (NB_TILES_X + 2) + (tx + 1);
+}
+
+#define cur_changed(ty, tx) (*changed_cell(_changed_tiles, (ty), (tx)))
+#define next_changed(ty, tx) (*changed_cell(_changed_tiles_alt, (ty), (tx)))
+
+static inline void swap_changed_tiles()
+{
+  char *tmp          = _changed_tiles;
+  _changed_tiles     = _changed_tiles_alt;
+  _changed_tiles_alt = tmp;
+}
+
+void ssandPile_init_lazy()
+{
+  const unsigned size = (NB_TILES_X + 2) * (NB_TILES_Y + 2);
+
+  ssandPile_init();
+
+  _changed_tiles     = calloc(size, 1);
+  _changed_tiles_alt = calloc(size, 1);
+  // Every tile has to be computed at least once (the halo ring stays clear)
+  for (int ty = 0; ty < NB_TILES_Y; ty++)
+    memset(&cur_changed(ty, 0), 1, NB_TILES_X);
+}
+
+void ssandPile_finalize_lazy()
+{
+  free(_changed_tiles);
+  free(_changed_tiles_alt);
+  ssandPile_finalize();
+}
+
+// Cells of a tile only depend on cells of the same tile and of its 4
+// neighbours. When none of them changed during the previous iteration, the
+// tile is skipped: both tables already hold the same (stable) values for it.
+unsigned ssandPile_compute_lazy(unsigned nb_iter)
+{
+  for (unsigned it = 1; it <= nb_iter; it++)
+  {
+    int change = 0;
+
+#pragma omp parallel for collapse(2) schedule(runtime) reduction(| : change)
+    for (int y = 0; y < DIM; y += TILE_H)
+      for (int x = 0; x < DIM; x += TILE_W)
+      {
+        int ty = y / TILE_H;
+        int tx = x / TILE_W;
+        int tile_change = 0;
+
+        if (cur_changed(ty, tx) || cur_changed(ty - 1, tx) ||
+            cur_changed(ty + 1, tx) || cur_changed(ty, tx - 1) ||
+            cur_changed(ty, tx + 1))
+          tile_change =
+              do_tile(x + (x == 0), y + (y == 0),
+                      TILE_W - ((x + TILE_W == DIM) + (x == 0)),
+                      TILE_H - ((y + TILE_H == DIM) + (y == 0)));
+
+        next_changed(ty, tx) = tile_change;
+        change |= tile_change;
+      }
+    swap_changed_tiles();
+    swap_tables();
+    if (change == 0)
+      return it;
+  }
+
+  return 0;
+}
+
+///////////////////////////// AVX2 tile version
+// ./run -k ssandPile -v lazy -wt avx -a 4partout -s 4096 -ts 64 -n
+
+#ifdef ENABLE_VECTO
+#include <immintrin.h>
+
+#if __AVX2__ == 1
+
+void ssandPile_tile_check_avx(void)
+{
+  // Tile width must be larger than AVX vector size
+#ifdef SANDPILE_U8
+  easypap_vec_check(AVX_VEC_SIZE_CHAR, DIR_HORIZONTAL);
+#else
+  easypap_vec_check(AVX_VEC_SIZE_INT, DIR_HORIZONTAL);
+#endif
+}
+
+#ifdef SANDPILE_U8
+
+// x % 4 and x / 4 are computed with masks and a shift on 32 cells at once.
+// Vectors containing (or producing) an overflowed cell are computed by the
+// scalar code.
+int ssandPile_do_tile_avx(int x, int y, int width, int height)
+{
+  const __m256i three  = _mm256_set1_epi8(3);
+  const __m256i low6   = _mm256_set1_epi8(0x3F);
+  const __m256i escape = _mm256_set1_epi8((char)SAND_ESCAPE);
+  __m256i diff         = _mm256_setzero_si256();
+  int change           = 0;
+
+  for (int i = y; i < y + height; i++)
+  {
+    const TYPE *restrict src = &table(in, i, 0);
+    TYPE *restrict dst       = &table(out, i, 0);
+    int j                    = x;
+
+    for (; j + AVX_VEC_SIZE_CHAR <= x + width; j += AVX_VEC_SIZE_CHAR)
+    {
+      __m256i c = _mm256_loadu_si256((const __m256i *)(src + j));
+      __m256i n = _mm256_loadu_si256((const __m256i *)(src + j - DIM));
+      __m256i s = _mm256_loadu_si256((const __m256i *)(src + j + DIM));
+      __m256i w = _mm256_loadu_si256((const __m256i *)(src + j - 1));
+      __m256i e = _mm256_loadu_si256((const __m256i *)(src + j + 1));
+
+      // There are no 8-bit shifts: shift 16-bit lanes and drop the bits
+      // coming from the upper byte
+      __m256i r = _mm256_and_si256(c, three);
+      r = _mm256_add_epi8(r, _mm256_and_si256(_mm256_srli_epi16(n, 2), low6));
+      r = _mm256_add_epi8(r, _mm256_and_si256(_mm256_srli_epi16(s, 2), low6));
+      r = _mm256_add_epi8(r, _mm256_and_si256(_mm256_srli_epi16(w, 2), low6));
+      r = _mm256_add_epi8(r, _mm256_and_si256(_mm256_srli_epi16(e, 2), low6));
+
+      // Inputs are <= 254, so r <= 3 + 4 * 63 = 255 never wraps around
+      __m256i esc = _mm256_cmpeq_epi8(c, escape);
+      esc = _mm256_or_si256(esc, _mm256_cmpeq_epi8(n, escape));
+      esc = _mm256_or_si256(esc, _mm256_cmpeq_epi8(s, escape));
+      esc = _mm256_or_si256(esc, _mm256_cmpeq_epi8(w, escape));
+      esc = _mm256_or_si256(esc, _mm256_cmpeq_epi8(e, escape));
+      esc = _mm256_or_si256(esc, _mm256_cmpeq_epi8(r, escape));
+
+      if (_mm256_testz_si256(esc, esc))
+      {
+        _mm256_storeu_si256((__m256i *)(dst + j), r);
+        diff = _mm256_or_si256(diff, _mm256_xor_si256(r, c));
+      }
+      else
+        change |= ssandPile_do_tile_default(j, i, AVX_VEC_SIZE_CHAR, 1);
+    }
+
+    if (j < x + width)
+      change |= ssandPile_do_tile_default(j, i, x + width - j, 1);
+  }
+
+  change |= !_mm256_testz_si256(diff, diff);
+  if (change)
+    mark_dirty_area(x, y, width, height);
+
+  return change;
+}
+
+#else
+
+// x % 4 and x / 4 are computed with a mask and a shift on 8 cells at once
+int ssandPile_do_tile_avx(int x, int y, int width, int height)
+{
+  const __m256i three = _mm256_set1_epi32(3);
+  __m256i diff        = _mm256_setzero_si256();
+  int change          = 0;
+
+  for (int i = y; i < y + height; i++)
+  {
+    const TYPE *restrict src = &table(in, i, 0);
+    TYPE *restrict dst       = &table(out, i, 0);
+    int j                    = x;
+
+    for (; j + AVX_VEC_SIZE_INT <= x + width; j += AVX_VEC_SIZE_INT)
+    {
+      __m256i c = _mm256_loadu_si256((const __m256i *)(src + j));
+      __m256i n = _mm256_loadu_si256((const __m256i *)(src + j - DIM));
+      __m256i s = _mm256_loadu_si256((const __m256i *)(src + j + DIM));
+      __m256i w = _mm256_loadu_si256((const __m256i *)(src + j - 1));
+      __m256i e = _mm256_loadu_si256((const __m256i *)(src + j + 1));
+
+      __m256i r = _mm256_and_si256(c, three);
+      r = _mm256_add_epi32(r, _mm256_srli_epi32(n, 2));
+      r = _mm256_add_epi32(r, _mm256_srli_epi32(s, 2));
+      r = _mm256_add_epi32(r, _mm256_srli_epi32(w, 2));
+      r = _mm256_add_epi32(r, _mm256_srli_epi32(e, 2));
+
+      _mm256_storeu_si256((__m256i *)(dst + j), r);
+      diff = _mm256_or_si256(diff, _mm256_xor_si256(r, c));
+    }
+
+    // Remaining cells (border tiles are narrower)
+    for (; j < x + width; j++)
+    {
+      dst[j] = (src[j] & 3) + (src[j - DIM] >> 2) + (src[j + DIM] >> 2) +
+               (src[j - 1] >> 2) + (src[j + 1] >> 2);
+      if (dst[j] != src[j])
+        change = 1;
+    }
+  }
+
+  change |= !_mm256_testz_si256(diff, diff);
+  if (change)
+    mark_dirty_area(x, y, width, height);
+
+  return change;
+}
+
+#endif // SANDPILE_U8
+
+#endif
+#endif
+
 #ifdef ENABLE_OPENCL
 
 // Only called when --dump or --thumbnails is used
@@ -249,11 +764,17 @@ void ssandPile_refresh_img_ocl ()
 {
   cl_int err;
 
+#ifdef SANDPILE_U8
+  exit_with_error ("OpenCL variants need 32-bit cells (undefine SANDPILE_U8)");
+#endif
+
   err =
       clEnqueueReadBuffer (ocl_queue (0), ocl_cur_buffer (0), CL_TRUE, 0,
                            sizeof (unsigned) * DIM * DIM, TABLE, 0, NULL, NULL);
   check (err, "Failed to read buffer from GPU");
 
+  // Tiles are computed on the GPU: changes are not tracked
+  mark_all_dirty ();
   ssandPile_refresh_img ();
 }
 
@@ -267,6 +788,10 @@ void ssandPile_refresh_img_ocl ()
 
 void asandPile_init()
 {
+#ifdef SANDPILE_U8
+  // Cells are toppled in place, possibly several times per sweep
+  exit_with_error ("asandPile needs 32-bit cells (undefine SANDPILE_U8)");
+#endif
   in = out = 0;
   if (TABLE == NULL)
   {
@@ -276,6 +801,9 @@ void asandPile_init()
 
     TABLE = mmap(NULL, size, PROT_READ | PROT_WRITE,
                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (use_numa_interleave())
+      numa_interleave_memory(TABLE, size, numa_all_nodes_ptr);
+    tile_info_alloc();
   }
 }
 
@@ -284,6 +812,24 @@ void asandPile_finalize()
   const unsigned size = DIM * DIM * sizeof(TYPE);
 
   munmap(TABLE, size);
+  tile_info_free();
+}
+
+void asandPile_ft()
+{
+#pragma omp parallel for collapse(2) schedule(runtime)
+  for (int y = 0; y < DIM; y += TILE_H)
+    for (int x = 0; x < DIM; x += TILE_W)
+      for (int i = y; i < y + TILE_H; i++)
+        for (int j = x; j < x + TILE_W; j++)
+          atable(i, j) = 0;
+}
+
+void asandPile_checkpoint (ezp_ckpt_region_t *r)
+{
+  r->base   = TABLE;
+  r->offset = 0;
+  r->size   = r->total = DIM * DIM * sizeof (TYPE);
 }
 
 ///////////////////////////// Version séquentielle simple (seq)
@@ -304,6 +850,11 @@ int asandPile_do_tile_default(int x, int y, int width, int height)
         atable(i, j) %= 4;
         change = 1;
       }
+
+  // Grains may have been pushed into neighbouring tiles
+  if (change)
+    mark_dirty_area(x - 1, y - 1, width + 2, height + 2);
+
   return change;
 }
 
@@ -338,4 +889,189 @@ unsigned asandPile_compute_tiled(unsigned nb_iter)
   }
 
   return 0;
-}
\ No newline at end of file
+}
+///////////////////////////// OpenMP version with 4-phase tile ordering (omp)
+// Suggested cmdline:
+// ./run -k asandPile -v omp -a 4partout -s 4096 -ts 64 -n
+//
+// A tile topples grains into the border cells of its 4 neighbours, so two
+// tiles touching by a side or by a corner cannot be processed concurrently
+// (diagonal neighbours both update the cells next to their common corner).
+// Tiles are split into 4 phases according to the parity of (ty, tx): tiles
+// of the same phase are at least one full tile apart, so each phase is
+// processed in parallel.
+
+// Tiles that may contain a cell >= 4 (bordered array)
+static char *_unstable_tiles = NULL;
+
+#define unstable(ty, tx) (*changed_cell(_unstable_tiles, (ty), (tx)))
+
+void asandPile_init_omp()
+{
+  const unsigned size = (NB_TILES_X + 2) * (NB_TILES_Y + 2);
+
+  asandPile_init();
+
+  _unstable_tiles = malloc(size);
+  memset(_unstable_tiles, 1, size);
+}
+
+void asandPile_finalize_omp()
+{
+  free(_unstable_tiles);
+  asandPile_finalize();
+}
+
+static inline void mark_unstable(int ty, int tx)
+{
+  // Neighbours of a tile may be marked by several tiles of the same phase
+  __atomic_store_n(&unstable(ty, tx), 1, __ATOMIC_RELAXED);
+}
+
+unsigned asandPile_compute_omp(unsigned nb_iter)
+{
+  for (unsigned it = 1; it <= nb_iter; it++)
+  {
+    int change = 0;
+
+    for (int phase = 0; phase < 4; phase++)
+    {
+#pragma omp parallel for collapse(2) schedule(runtime) reduction(| : change)
+      for (int ty = phase >> 1; ty < NB_TILES_Y; ty += 2)
+        for (int tx = phase & 1; tx < NB_TILES_X; tx += 2)
+        {
+          if (!unstable(ty, tx))
+            continue;
+
+          int x = tx * TILE_W;
+          int y = ty * TILE_H;
+
+          unstable(ty, tx) = 0;
+          if (do_tile(x + (x == 0), y + (y == 0),
+                      TILE_W - ((x + TILE_W == DIM) + (x == 0)),
+                      TILE_H - ((y + TILE_H == DIM) + (y == 0))))
+          {
+            // Cells of the tile may still be >= 4, and neighbours received
+            // grains
+            mark_unstable(ty, tx);
+            mark_unstable(ty - 1, tx);
+            mark_unstable(ty + 1, tx);
+            mark_unstable(ty, tx - 1);
+            mark_unstable(ty, tx + 1);
+            change = 1;
+          }
+        }
+    }
+    if (change == 0)
+      return it;
+  }
+
+  return 0;
+}
+
+///////////////////////////// Worklist-based bulk toppling (bulk)
+// Suggested cmdline:
+// ./run -k asandPile -v bulk -a big -s 512 -n
+//
+// Thanks to the abelian property, the final configuration does not depend on
+// the order of topplings: a cell holding v grains can topple v / 4 times at
+// once. Only cells >= 4 are visited, so the work is proportional to the number
+// of topplings instead of (number of sweeps x DIM^2). One iteration processes
+// the whole current worklist.
+
+static int *_worklist      = NULL;
+static int *_next_worklist = NULL;
+static char *_queued       = NULL;
+static int worklist_size   = -1; // -1: worklist must be (re)built
+
+void asandPile_init_bulk()
+{
+  asandPile_init();
+
+  PRINT_DEBUG('u', "Worklists = 2 x %d bytes\n",
+              (int)(DIM * DIM * sizeof(int)));
+
+  _worklist      = malloc(DIM * DIM * sizeof(int));
+  _next_worklist = malloc(DIM * DIM * sizeof(int));
+  _queued        = calloc(DIM * DIM, 1);
+  worklist_size  = -1;
+}
+
+void asandPile_finalize_bulk()
+{
+  free(_worklist);
+  free(_next_worklist);
+  free(_queued);
+  asandPile_finalize();
+}
+
+// Cells of the outer border are sinks: they are never toppled
+static inline void push_if_unstable(int cell, int *restrict next, int *size)
+{
+  int y = cell / DIM, x = cell % DIM;
+
+  if (TABLE[cell] >= 4 && !_queued[cell] && y > 0 && y < DIM - 1 && x > 0 &&
+      x < DIM - 1)
+  {
+    _queued[cell]   = 1;
+    next[(*size)++] = cell;
+  }
+}
+
+// The initial configuration (or restored checkpoint) is only known when the
+// first iteration starts
+static void build_worklist(void)
+{
+  worklist_size = 0;
+  for (int i = 1; i < DIM - 1; i++)
+    for (int j = 1; j < DIM - 1; j++)
+      push_if_unstable(i * DIM + j, _worklist, &worklist_size);
+}
+
+unsigned asandPile_compute_bulk(unsigned nb_iter)
+{
+  if (worklist_size == -1)
+    build_worklist();
+
+  for (unsigned it = 1; it <= nb_iter; it++)
+  {
+    int next_size = 0;
+
+    if (worklist_size == 0)
+      return it;
+
+    monitoring_start(0);
+
+    for (int w = 0; w < worklist_size; w++)
+    {
+      int cell = _worklist[w];
+      TYPE k   = TABLE[cell] / 4;
+
+      // The cell may be pushed again if its neighbours give it enough grains
+      _queued[cell] = 0;
+      if (k == 0)
+        continue;
+
+      TABLE[cell] %= 4;
+      TABLE[cell - 1] += k;
+      TABLE[cell + 1] += k;
+      TABLE[cell - DIM] += k;
+      TABLE[cell + DIM] += k;
+      mark_dirty_area(cell % DIM - 1, cell / DIM - 1, 3, 3);
+
+      push_if_unstable(cell - 1, _next_worklist, &next_size);
+      push_if_unstable(cell + 1, _next_worklist, &next_size);
+      push_if_unstable(cell - DIM, _next_worklist, &next_size);
+      push_if_unstable(cell + DIM, _next_worklist, &next_size);
+    }
+
+    monitoring_end_tile(0, 0, DIM, DIM, 0);
+
+    int *tmp       = _worklist;
+    _worklist      = _next_worklist;
+    _next_worklist = tmp;
+    worklist_size  = next_size;
+  }
+
+  return 0;
+}
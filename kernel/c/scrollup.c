@@ -3,6 +3,7 @@
 
 #include <fcntl.h>
 #include <omp.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -57,6 +58,60 @@ unsigned scrollup_compute_tiled (unsigned nb_iter)
 
   return 0;
 }
+///////////////////////////// Ring version (ring)
+// Suggested cmdline(s):
+// ./run -l data/img/1024.png -k scrollup -v ring
+//
+// Scrolling never moves pixels: the picture is kept in alt_image, seen as a
+// ring of DIM rows, and only the index of the row currently displayed at the
+// top advances. Since the scroll is cyclic, the row leaving the top is
+// already where it belongs at the bottom of the ring. The shift is applied
+// when the image is actually needed (display, hash, checkpoint).
+static unsigned ring_base  = 0;
+static unsigned ring_ready = 0;
+
+static void ring_capture (void)
+{
+  // image may have been loaded, drawn or restored from a checkpoint
+  img_data_replicate ();
+  ring_base  = 0;
+  ring_ready = 1;
+}
+
+unsigned scrollup_compute_ring (unsigned nb_iter)
+{
+  if (!ring_ready)
+    ring_capture ();
+
+  ring_base = (ring_base + nb_iter) % DIM;
+
+  return 0;
+}
+
+// Displayed row i is ring row (i + ring_base) % DIM: two contiguous copies
+void scrollup_refresh_img_ring (void)
+{
+  if (!ring_ready)
+    return;
+
+  const unsigned top = DIM - ring_base;
+
+  memcpy (image, alt_image + ring_base * DIM, top * DIM * sizeof (unsigned));
+  memcpy (image + top * DIM, alt_image, ring_base * DIM * sizeof (unsigned));
+}
+
+void scrollup_checkpoint_ring (ezp_ckpt_region_t *r)
+{
+  // Save the scrolled image; the ring is rebuilt from it after a restart
+  scrollup_refresh_img_ring ();
+  ring_ready = 0;
+
+  r->base   = image;
+  r->offset = 0;
+  r->size   = DIM * DIM * sizeof (unsigned);
+  r->total  = DIM * DIM * sizeof (unsigned);
+}
+
 #define ENABLE_OPENCL
 #ifdef ENABLE_OPENCL
 
@@ -182,4 +237,57 @@ unsigned scrollup_compute_ocl_ouf (unsigned nb_iter)
   return 0;
 }
 
+//////////// OpenCL ring version (ocl_ring)
+// Suggested cmdlines:
+// ./run -l data/img/shibuya.png -k scrollup -g -v ocl_ring
+//
+// Same idea as the CPU ring version: the picture is kept in the next buffer
+// and only the row offset moves. The scrolled image is materialized once per
+// call, whatever the number of iterations, and works for any DIM.
+
+static unsigned ocl_ring_base  = 0;
+static unsigned ocl_ring_ready = 0;
+
+unsigned scrollup_compute_ocl_ring (unsigned nb_iter)
+{
+  size_t global[2] = {GPU_SIZE_X,
+                      GPU_SIZE_Y};     // global domain size for our calculation
+  size_t local[2]  = {TILE_W, TILE_H}; // local domain size for our calculation
+  cl_int err;
+
+  monitoring_start (easypap_gpu_lane (0));
+
+  if (!ocl_ring_ready) {
+    err = clEnqueueCopyBuffer (ocl_queue (0), ocl_cur_buffer (0),
+                               ocl_next_buffer (0), 0, 0,
+                               DIM * DIM * sizeof (unsigned), 0, NULL, NULL);
+    check (err, "Failed to copy image into ring buffer");
+    ocl_ring_base  = 0;
+    ocl_ring_ready = 1;
+  }
+
+  ocl_ring_base = (ocl_ring_base + nb_iter) % DIM;
+
+  // Set kernel arguments
+  //
+  err = 0;
+  err |= clSetKernelArg (ocl_compute_kernel (0), 0, sizeof (cl_mem),
+                         &ocl_next_buffer (0));
+  err |= clSetKernelArg (ocl_compute_kernel (0), 1, sizeof (cl_mem),
+                         &ocl_cur_buffer (0));
+  err |= clSetKernelArg (ocl_compute_kernel (0), 2, sizeof (unsigned),
+                         &ocl_ring_base);
+  check (err, "Failed to set kernel arguments");
+
+  err = clEnqueueNDRangeKernel (ocl_queue (0), ocl_compute_kernel (0), 2, NULL,
+                                global, local, 0, NULL, NULL);
+  check (err, "Failed to execute kernel");
+
+  clFinish (ocl_queue (0));
+
+  monitoring_end_tile (0, 0, DIM, DIM, easypap_gpu_lane (0));
+
+  return 0;
+}
+
 #endif
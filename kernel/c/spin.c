@@ -6,6 +6,7 @@
 
 static void rotate (void);
 static unsigned compute_color (int i, int j);
+static void build_angle_field (void);
 
 // If defined, the initialization hook function is called quite early in the
 // initialization process, after the size (DIM variable) of images is known.
@@ -21,6 +22,8 @@ void spin_init (void)
   PRINT_DEBUG ('u', "Image size is %dx%d\n", DIM, DIM);
   PRINT_DEBUG ('u', "Block size is %dx%d\n", TILE_W, TILE_H);
   PRINT_DEBUG ('u', "Press <SPACE> to pause/unpause, <ESC> to quit.\n");
+
+  build_angle_field ();
 }
 
 // The image is a two-dimension array of size of DIM x DIM. Each pixel is of
@@ -135,6 +138,70 @@ static void rotate (void)
   base_angle = fmodf (base_angle + (1.0 / 180.0) * M_PI, M_PI);
 }
 
+///////////////////////////// Precomputed angle field (lut)
+// Suggested cmdline(s):
+// ./run -k spin -v omp_tiled -wt lut -ts 64
+//
+// The colour of a pixel only depends on its angle modulo π/4, and the angle
+// of a pixel relative to the centre never changes: only base_angle does. The
+// angle of each pixel is thus computed once, as a 16-bit fixed-point fraction
+// of π/4. Each frame then boils down to a 16-bit addition (wrapping around
+// is the modulo) followed by a lookup in a colour table.
+// -wt lut_avx2 and -wt lut_avx512 perform the lookups with gathers (when
+// compiled with AVX2 / AVX-512 support).
+
+#define LUT_BITS 10
+#define LUT_SHIFT (16 - LUT_BITS)
+
+static uint16_t *angle_field = NULL;
+static uint32_t colour_lut[1 << LUT_BITS];
+
+static inline uint16_t angle_to_phase (float angle)
+{
+  float u = fmodf (angle, M_PI / 4.0) / (float)(M_PI / 4.0); // [0,1[
+
+  return (uint16_t)(u * 65536.0f);
+}
+
+static void build_angle_field (void)
+{
+  angle_field = malloc (DIM * DIM * sizeof (uint16_t));
+
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < DIM; i++)
+    for (int j = 0; j < DIM; j++)
+      angle_field[i * DIM + j] = angle_to_phase (
+          atan2f_approx ((int)DIM / 2 - i, j - (int)DIM / 2) + M_PI);
+
+  for (int k = 0; k < (1 << LUT_BITS); k++) {
+    float ratio = fabsf (2.0f * (k + 0.5f) / (1 << LUT_BITS) - 1.0f);
+
+    uint8_t r = blue_r + (yellow_r - blue_r) * ratio;
+    uint8_t g = blue_g + (yellow_g - blue_g) * ratio;
+    uint8_t b = blue_b + (yellow_b - blue_b) * ratio;
+    uint8_t a = blue_a + (yellow_a - blue_a) * ratio;
+
+    colour_lut[k] = ezv_rgba (r, g, b, a);
+  }
+}
+
+void spin_finalize (void)
+{
+  free (angle_field);
+}
+
+int spin_do_tile_lut (int x, int y, int width, int height)
+{
+  const uint16_t base = angle_to_phase (base_angle);
+
+  for (int i = y; i < y + height; i++)
+    for (int j = x; j < x + width; j++)
+      cur_img (i, j) =
+          colour_lut[(uint16_t)(angle_field[i * DIM + j] + base) >> LUT_SHIFT];
+
+  return 0;
+}
+
 
 // Intrinsics functions
 #ifdef ENABLE_VECTO
@@ -280,6 +347,72 @@ int spin_do_tile_avx (int x, int y, int width, int height)
   return 0;
 }
 
-#endif
-#endif
+void spin_tile_check_lut_avx2 (void)
+{
+  // Tile width must be larger than AVX vector size
+  easypap_vec_check (AVX_VEC_SIZE_INT, DIR_HORIZONTAL);
+}
+
+int spin_do_tile_lut_avx2 (int x, int y, int width, int height)
+{
+  const __m256i base = _mm256_set1_epi32 (angle_to_phase (base_angle));
+  const __m256i mask = _mm256_set1_epi32 (0xFFFF);
+
+  for (int i = y; i < y + height; i++) {
+    int j = x;
+
+    for (; j + 8 <= x + width; j += 8) {
+      __m256i phase = _mm256_cvtepu16_epi32 (
+          _mm_loadu_si128 ((__m128i *)&angle_field[i * DIM + j]));
+
+      phase = _mm256_and_si256 (_mm256_add_epi32 (phase, base), mask);
+      phase = _mm256_srli_epi32 (phase, LUT_SHIFT);
+
+      _mm256_storeu_si256 ((__m256i *)&cur_img (i, j),
+                           _mm256_i32gather_epi32 ((int *)colour_lut, phase, 4));
+    }
+    if (j < x + width)
+      spin_do_tile_lut (j, i, x + width - j, 1);
+  }
+
+  return 0;
+}
+
+#endif // AVX2
+
+#if __AVX512F__ == 1
 
+void spin_tile_check_lut_avx512 (void)
+{
+  // Tile width must be larger than AVX-512 vector size
+  easypap_vec_check (AVX512_VEC_SIZE_INT, DIR_HORIZONTAL);
+}
+
+int spin_do_tile_lut_avx512 (int x, int y, int width, int height)
+{
+  const __m512i base = _mm512_set1_epi32 (angle_to_phase (base_angle));
+  const __m512i mask = _mm512_set1_epi32 (0xFFFF);
+
+  for (int i = y; i < y + height; i++) {
+    int j = x;
+
+    for (; j + 16 <= x + width; j += 16) {
+      __m512i phase = _mm512_cvtepu16_epi32 (
+          _mm256_loadu_si256 ((__m256i *)&angle_field[i * DIM + j]));
+
+      phase = _mm512_and_si512 (_mm512_add_epi32 (phase, base), mask);
+      phase = _mm512_srli_epi32 (phase, LUT_SHIFT);
+
+      _mm512_storeu_si512 (&cur_img (i, j),
+                           _mm512_i32gather_epi32 (phase, colour_lut, 4));
+    }
+    if (j < x + width)
+      spin_do_tile_lut (j, i, x + width - j, 1);
+  }
+
+  return 0;
+}
+
+#endif // AVX512
+
+#endif
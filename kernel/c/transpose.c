@@ -3,6 +3,8 @@
 
 #include <omp.h>
 
+#include "transpose_helpers.h"
+
 // Tile inner computation
 int transpose_do_tile_default (int x, int y, int width, int height)
 {
@@ -47,3 +49,50 @@ unsigned transpose_compute_tiled (unsigned nb_iter)
 
   return 0;
 }
+
+///////////////////////////// Tiled parallel version (omp_tiled)
+// Suggested cmdline:
+// ./run -l data/img/shibuya.png -k transpose -v omp_tiled -wt co -ts 64
+// ./run -l data/img/shibuya.png -k transpose -v omp_tiled -wt co_avx2 -ts 64
+//
+unsigned transpose_compute_omp_tiled (unsigned nb_iter)
+{
+  for (unsigned it = 1; it <= nb_iter; it++) {
+
+#pragma omp parallel for collapse(2) schedule(runtime)
+    for (int y = 0; y < DIM; y += TILE_H)
+      for (int x = 0; x < DIM; x += TILE_W)
+        do_tile (x, y, TILE_W, TILE_H);
+
+    swap_images ();
+  }
+
+  return 0;
+}
+
+///////////////////////////// Cache-oblivious tile versions (co, co_avx2)
+// See transpose_helpers.h
+
+int transpose_do_tile_co (int x, int y, int width, int height)
+{
+  co_transpose (x, y, width, height, 0, 0);
+
+  return 0;
+}
+
+#if CO_AVX2
+
+void transpose_tile_check_co_avx2 (void)
+{
+  // Tile width must be larger than AVX vector size
+  easypap_vec_check (AVX_VEC_SIZE_INT, DIR_HORIZONTAL);
+}
+
+int transpose_do_tile_co_avx2 (int x, int y, int width, int height)
+{
+  co_transpose (x, y, width, height, 0, 1);
+
+  return 0;
+}
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef TRANSPOSE_HELPERS_H
+#define TRANSPOSE_HELPERS_H
+
+// Cache-oblivious transposition, shared by the transpose and rotation90
+// kernels. For i in [y, y + height[ and j in [x, x + width[:
+//   next_img (dst_row (i), j) = cur_img (j, i)
+// with dst_row (i) = i, or DIM - 1 - i when 'mirror' is set.
+//
+// The area is recursively split in two along its largest dimension, so that
+// source and destination blocks fit in cache whatever its size, down to 8x8
+// blocks. When 'avx2' is set (only when compiled with AVX2 support), these
+// blocks are transposed in AVX2 registers.
+
+static inline int co_dst_row (int i, int mirror)
+{
+  return mirror ? DIM - 1 - i : i;
+}
+
+static void co_block_scalar (int x, int y, int width, int height, int mirror)
+{
+  for (int i = y; i < y + height; i++)
+    for (int j = x; j < x + width; j++)
+      next_img (co_dst_row (i, mirror), j) = cur_img (j, i);
+}
+
+#if defined(ENABLE_VECTO) && __AVX2__ == 1
+#include <immintrin.h>
+
+#define CO_AVX2 1
+
+// Destination lines are written with non-temporal stores: they are not read
+// again before the next iteration
+static void co_block_8x8_avx2 (int x, int y, int mirror)
+{
+  __m256i r[8], t[8], u[8];
+
+  for (int k = 0; k < 8; k++)
+    r[k] = _mm256_loadu_si256 ((__m256i *)&cur_img (x + k, y));
+
+  for (int k = 0; k < 8; k += 2) {
+    t[k]     = _mm256_unpacklo_epi32 (r[k], r[k + 1]);
+    t[k + 1] = _mm256_unpackhi_epi32 (r[k], r[k + 1]);
+  }
+  for (int k = 0; k < 8; k += 4) {
+    u[k]     = _mm256_unpacklo_epi64 (t[k], t[k + 2]);
+    u[k + 1] = _mm256_unpackhi_epi64 (t[k], t[k + 2]);
+    u[k + 2] = _mm256_unpacklo_epi64 (t[k + 1], t[k + 3]);
+    u[k + 3] = _mm256_unpackhi_epi64 (t[k + 1], t[k + 3]);
+  }
+
+  for (int c = 0; c < 4; c++) {
+    __m256i *lo = (__m256i *)&next_img (co_dst_row (y + c, mirror), x);
+    __m256i *hi = (__m256i *)&next_img (co_dst_row (y + c + 4, mirror), x);
+    __m256i vlo = _mm256_permute2x128_si256 (u[c], u[c + 4], 0x20);
+    __m256i vhi = _mm256_permute2x128_si256 (u[c], u[c + 4], 0x31);
+
+    if (((uintptr_t)lo & 31) == 0 && ((uintptr_t)hi & 31) == 0) {
+      _mm256_stream_si256 (lo, vlo);
+      _mm256_stream_si256 (hi, vhi);
+    } else {
+      _mm256_storeu_si256 (lo, vlo);
+      _mm256_storeu_si256 (hi, vhi);
+    }
+  }
+}
+
+#else
+
+#define CO_AVX2 0
+
+#endif
+
+static void co_transpose_rec (int x, int y, int width, int height, int mirror,
+                              int avx2)
+{
+  if (width <= 8 && height <= 8) {
+#if CO_AVX2
+    if (avx2 && width == 8 && height == 8) {
+      co_block_8x8_avx2 (x, y, mirror);
+      return;
+    }
+#endif
+    co_block_scalar (x, y, width, height, mirror);
+    return;
+  }
+
+  // Halves are kept multiple of 8 whenever possible
+  if (width >= height) {
+    int w = (width / 2) & ~7;
+    if (w == 0)
+      w = width / 2;
+    co_transpose_rec (x, y, w, height, mirror, avx2);
+    co_transpose_rec (x + w, y, width - w, height, mirror, avx2);
+  } else {
+    int h = (height / 2) & ~7;
+    if (h == 0)
+      h = height / 2;
+    co_transpose_rec (x, y, width, h, mirror, avx2);
+    co_transpose_rec (x, y + h, width, height - h, mirror, avx2);
+  }
+}
+
+static void co_transpose (int x, int y, int width, int height, int mirror,
+                          int avx2)
+{
+  co_transpose_rec (x, y, width, height, mirror, avx2);
+#if CO_AVX2
+  // Make non-temporal stores visible before the images are swapped
+  if (avx2)
+    _mm_sfence ();
+#endif
+}
+
+#endif
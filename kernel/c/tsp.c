@@ -17,6 +17,10 @@ typedef int chemin_t[MAX_NBVILLES];
 /* dernier minimum trouv� */
 int minimum = INT_MAX;
 
+/* chemin correspondant (protégé par la section critique tsp_best) */
+static int best_lg = INT_MAX;
+static chemin_t best_chemin;
+
 /* tableau des distances */
 DTab_t distance;
 
@@ -40,6 +44,7 @@ void initialisation ()
   /* initialisation du tableau des distances */
   /* on positionne les villes aléatoirement sur une carte MAXX x MAXY  */
   minimum = INT_MAX;
+  best_lg = INT_MAX;
   coortab_t lesVilles;
 
   int i, j;
@@ -65,17 +70,33 @@ int present (int ville, int mask)
   return mask & (1 << ville);
 }
 
+// May be called concurrently: minimum is updated with a CAS, and the path is
+// only printed at the end of the search (see afficher_minimum)
 void verifier_minimum (int lg, chemin_t chemin)
 {
-    if (lg + distance[0][chemin[nbVilles - 1]] < minimum) {
-      minimum = lg + distance[0][chemin[nbVilles - 1]];
-      printf ("%3d par %d :", minimum, omp_get_thread_num ());
-      for (int i = 0; i < nbVilles; i++)
-        printf ("%2d ", chemin[i]);
-      printf ("\n");
+  int total = lg + distance[0][chemin[nbVilles - 1]];
+  int cur   = __atomic_load_n (&minimum, __ATOMIC_RELAXED);
+
+  while (total < cur)
+    if (__atomic_compare_exchange_n (&minimum, &cur, total, 0,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+#pragma omp critical(tsp_best)
+      if (total < best_lg) {
+        best_lg = total;
+        memcpy (best_chemin, chemin, sizeof (chemin_t));
+      }
+      break;
     }
 }
 
+void afficher_minimum (void)
+{
+  printf ("%3d :", best_lg);
+  for (int i = 0; i < nbVilles; i++)
+    printf ("%2d ", best_chemin[i]);
+  printf ("\n");
+}
+
 static void tsp_monitor (int etape, int lg, chemin_t chemin, int mask);
 
 void tsp_seq (int etape, int lg, chemin_t chemin, int mask)
@@ -146,6 +167,7 @@ int tsp_compute_seq (unsigned nb_iter)
     chemin_t chemin;
     chemin[0] = 0;
     tsp_monitor (1, 0, chemin, 1);
+    afficher_minimum ();
   }
   return 0;
 }
@@ -246,8 +268,8 @@ void tsp_draw (char *param)
   }
 }
 
-static void emplacement(int *x, int *y, int *largeur, int *hauteur, chemin_t chemin, int etape){
-  if (etape > grain)
+static void emplacement(int *x, int *y, int *largeur, int *hauteur, chemin_t chemin, int etape, int max_etape){
+  if (etape > max_etape)
     return;
   if (*largeur > *hauteur){
     *largeur /= nbVilles - 1;
@@ -256,16 +278,354 @@ static void emplacement(int *x, int *y, int *largeur, int *hauteur, chemin_t che
     *hauteur /= nbVilles - 1;
     *y += (chemin[etape] - 1) * *hauteur;
   }
-  emplacement (x, y, largeur, hauteur, chemin, etape + 1);
+  emplacement (x, y, largeur, hauteur, chemin, etape + 1, max_etape);
 }
 
 static void tsp_monitor (int etape, int lg, chemin_t chemin, int mask)
 {
   int x = 0, y = 0, largeur = DIM, hauteur = DIM;
 
-  emplacement (&x, &y, &largeur, &hauteur, chemin, 1);
+  emplacement (&x, &y, &largeur, &hauteur, chemin, 1, grain);
 
   monitoring_start (omp_get_thread_num ());
   tsp_seq (etape, lg, chemin, mask);
   monitoring_end_tile (x, y, largeur, hauteur, omp_get_thread_num ());
 }
+
+///////////////////////////// Work stealing branch-and-bound (ws)
+// Suggested cmdline:
+// ./run -k tsp -v ws -a 20-2 -i 1
+//
+// Partial paths (tasks) are stored in per-thread deques: the owner pushes and
+// pops at the bottom (depth-first, nearest cities first), idle threads steal
+// the oldest task (i.e. the largest subtree) at the top of a random victim's
+// deque. Near the leaves, subtrees are explored sequentially.
+//
+// Pruning uses the following lower bound: every unvisited city, and the
+// starting city, still has to be entered through at least its shortest
+// incoming edge.
+
+#define WS_SEQ_CITIES 10 /* villes restantes en dessous desquelles on ne
+                            découpe plus */
+#define WS_CAPACITY (2 * MAX_NBVILLES * MAX_NBVILLES)
+
+// Depth used to place subtrees in the trace (grain, clamped by ws)
+static int ws_grain = 0;
+
+typedef struct
+{
+  int etape, lg, reste, mask;
+  chemin_t chemin;
+} tache_t;
+
+typedef struct
+{
+  omp_lock_t lock;
+  int top, bottom; // tâches dans [top, bottom[ (modulo WS_CAPACITY)
+  tache_t taches[WS_CAPACITY];
+} deque_t;
+
+static deque_t *deques = NULL;
+static int pending; // tâches présentes dans les deques ou en cours
+
+/* plus courte arête entrante de chaque ville */
+static int min_in[MAX_NBVILLES];
+
+static inline int borne_inf (int lg, int reste)
+{
+  return lg + reste + min_in[0];
+}
+
+static void tsp_bb (int etape, int lg, int reste, chemin_t chemin, int mask)
+{
+  if (borne_inf (lg, reste) >= __atomic_load_n (&minimum, __ATOMIC_RELAXED))
+    return;
+
+  if (etape == nbVilles)
+    verifier_minimum (lg, chemin);
+  else {
+    int ici = chemin[etape - 1];
+
+    for (int i = 1; i < nbVilles; i++)
+      if (!present (i, mask)) {
+        chemin[etape] = i;
+        tsp_bb (etape + 1, lg + distance[ici][i], reste - min_in[i], chemin,
+                mask | (1 << i));
+      }
+  }
+}
+
+static int deque_push (deque_t *d, tache_t *t)
+{
+  int ok = 0;
+
+  omp_set_lock (&d->lock);
+  if (d->bottom - d->top < WS_CAPACITY) {
+    d->taches[d->bottom % WS_CAPACITY] = *t;
+    d->bottom++;
+    ok = 1;
+  }
+  omp_unset_lock (&d->lock);
+
+  return ok;
+}
+
+static int deque_pop (deque_t *d, tache_t *t, int steal)
+{
+  int ok = 0;
+
+  omp_set_lock (&d->lock);
+  if (d->bottom > d->top) {
+    if (steal)
+      *t = d->taches[d->top++ % WS_CAPACITY];
+    else
+      *t = d->taches[--d->bottom % WS_CAPACITY];
+    ok = 1;
+  }
+  omp_unset_lock (&d->lock);
+
+  return ok;
+}
+
+static void ws_explore (tache_t *t)
+{
+  int x = 0, y = 0, largeur = DIM, hauteur = DIM;
+
+  emplacement (&x, &y, &largeur, &hauteur, t->chemin, 1, ws_grain);
+
+  monitoring_start (omp_get_thread_num ());
+  tsp_bb (t->etape, t->lg, t->reste, t->chemin, t->mask);
+  monitoring_end_tile (x, y, largeur, hauteur, omp_get_thread_num ());
+}
+
+static void ws_process (deque_t *d, tache_t *t)
+{
+  if (borne_inf (t->lg, t->reste) >=
+      __atomic_load_n (&minimum, __ATOMIC_RELAXED))
+    return;
+
+  if (nbVilles - t->etape <= WS_SEQ_CITIES) {
+    ws_explore (t);
+    return;
+  }
+
+  // Children are pushed farthest first, so that the nearest city is
+  // explored first by the owner
+  int villes[MAX_NBVILLES], nb = 0, ici = t->chemin[t->etape - 1];
+
+  for (int i = 1; i < nbVilles; i++)
+    if (!present (i, t->mask)) {
+      int k = nb++;
+      while (k > 0 && distance[ici][villes[k - 1]] < distance[ici][i]) {
+        villes[k] = villes[k - 1];
+        k--;
+      }
+      villes[k] = i;
+    }
+
+  __atomic_fetch_add (&pending, nb, __ATOMIC_RELAXED);
+  for (int k = 0; k < nb; k++) {
+    tache_t fils = *t;
+    int i        = villes[k];
+
+    fils.chemin[fils.etape] = i;
+    fils.etape++;
+    fils.lg += distance[ici][i];
+    fils.reste -= min_in[i];
+    fils.mask |= 1 << i;
+
+    if (!deque_push (d, &fils)) {
+      ws_explore (&fils);
+      __atomic_fetch_sub (&pending, 1, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+static void tsp_ws (void)
+{
+  const int nb_threads = omp_get_max_threads ();
+  tache_t racine       = {.etape = 1, .lg = 0, .reste = 0, .mask = 1};
+
+  for (int v = 0; v < nbVilles; v++) {
+    min_in[v] = INT_MAX;
+    for (int u = 0; u < nbVilles; u++)
+      if (u != v && distance[u][v] < min_in[v])
+        min_in[v] = distance[u][v];
+    if (v > 0)
+      racine.reste += min_in[v];
+  }
+  racine.chemin[0] = 0;
+
+  deques = malloc (nb_threads * sizeof (deque_t));
+  for (int t = 0; t < nb_threads; t++) {
+    omp_init_lock (&deques[t].lock);
+    deques[t].top = deques[t].bottom = 0;
+  }
+
+  pending = 1;
+  deque_push (&deques[0], &racine);
+
+#pragma omp parallel num_threads(nb_threads)
+  {
+    const int me      = omp_get_thread_num ();
+    unsigned int seed = me + 1;
+    tache_t t;
+
+    while (__atomic_load_n (&pending, __ATOMIC_ACQUIRE) > 0) {
+      if (deque_pop (&deques[me], &t, 0) ||
+          deque_pop (&deques[rand_r (&seed) % nb_threads], &t, 1)) {
+        ws_process (&deques[me], &t);
+        __atomic_fetch_sub (&pending, 1, __ATOMIC_RELEASE);
+      }
+    }
+  }
+
+  for (int t = 0; t < nb_threads; t++)
+    omp_destroy_lock (&deques[t].lock);
+  free (deques);
+}
+
+int tsp_compute_ws (unsigned nb_iter)
+{
+  // Subtrees explored sequentially start at depth nbVilles - WS_SEQ_CITIES:
+  // only the cities chosen before can be used to place them in the trace
+  ws_grain = MAX (MIN (grain, nbVilles - WS_SEQ_CITIES - 1), 0);
+  if (ws_grain != grain)
+    PRINT_DEBUG ('u', "tsp: trace grain clamped to %d\n", ws_grain);
+
+  for (int step = 1; step <= nb_iter; step++) {
+
+    initialisation ();
+    tsp_ws ();
+    afficher_minimum ();
+  }
+  return 0;
+}
+
+///////////////////////////// Held-Karp dynamic programming (heldkarp)
+// Suggested cmdline:
+// ./run -k tsp -v heldkarp -a 20-1 -i 1
+//
+// cout[S][j] = length of the shortest path starting from city 0, visiting
+// every city of S (subset of cities 1..nbVilles-1) and ending in j (j in S).
+// Subsets are processed by increasing cardinality: all the subsets of a layer
+// only depend on the previous layer, so each layer is computed in parallel.
+// The table is stored subset-major (the nbVilles - 1 entries of a subset are
+// contiguous), so that reading cout[S \ {j}][*] streams through memory.
+// Subsets are sorted by cardinality once (counting sort), so that a layer only
+// visits its own subsets, in increasing order. A layer is distributed by
+// small chunks of consecutive subsets: neighbouring subsets share most of
+// their predecessors, which are then reused from cache by the same thread.
+// Memory footprint: 2^(nbVilles-1) x (nbVilles-1) ints + 2^(nbVilles-1)
+// unsigned.
+
+#define HK_CHUNK 64
+
+static void tsp_heldkarp (void)
+{
+  const int m        = nbVilles - 1; // city c is bit c - 1
+  const unsigned nbS = 1U << m;
+  int *cout          = malloc ((size_t)nbS * m * sizeof (int));
+
+  if (cout == NULL)
+    exit_with_error ("Held-Karp: cannot allocate %zu bytes",
+                     (size_t)nbS * m * sizeof (int));
+
+#define cout(S, j) cout[(size_t)(S) * m + (j)]
+
+  // layer[first[k] .. first[k + 1]) = subsets of cardinality k
+  unsigned *layer = malloc ((size_t)nbS * sizeof (unsigned));
+  unsigned first[MAX_NBVILLES + 1] = {0};
+
+  if (layer == NULL)
+    exit_with_error ("Held-Karp: cannot allocate %zu bytes",
+                     (size_t)nbS * sizeof (unsigned));
+
+  for (unsigned S = 0; S < nbS; S++)
+    first[__builtin_popcount (S) + 1]++;
+  for (int k = 1; k <= m + 1; k++)
+    first[k] += first[k - 1];
+  {
+    unsigned next[MAX_NBVILLES];
+
+    memcpy (next, first, (m + 1) * sizeof (unsigned));
+    for (unsigned S = 0; S < nbS; S++)
+      layer[next[__builtin_popcount (S)]++] = S;
+  }
+
+  for (int j = 0; j < m; j++)
+    cout (1U << j, j) = distance[0][j + 1];
+
+  for (int k = 2; k <= m; k++) {
+#pragma omp parallel
+    {
+      monitoring_start (omp_get_thread_num ());
+
+#pragma omp for schedule(dynamic, HK_CHUNK) nowait
+      for (unsigned n = first[k]; n < first[k + 1]; n++) {
+        const unsigned S = layer[n];
+
+        for (int j = 0; j < m; j++) {
+          if (!(S & (1U << j)))
+            continue;
+
+          const unsigned prev = S & ~(1U << j);
+          int best            = INT_MAX;
+
+          for (int i = 0; i < m; i++)
+            if ((prev & (1U << i)) &&
+                cout (prev, i) + distance[i + 1][j + 1] < best)
+              best = cout (prev, i) + distance[i + 1][j + 1];
+
+          cout (S, j) = best;
+        }
+      }
+
+      monitoring_end_tile (omp_get_thread_num () * DIM / omp_get_num_threads (),
+                           (k - 2) * DIM / m, DIM / omp_get_num_threads (),
+                           DIM / m, omp_get_thread_num ());
+    }
+  }
+
+  // Close the tour, then rebuild it backwards
+  unsigned S = nbS - 1;
+  int last   = 0;
+
+  minimum = INT_MAX;
+  for (int j = 0; j < m; j++)
+    if (cout (S, j) + distance[j + 1][0] < minimum) {
+      minimum = cout (S, j) + distance[j + 1][0];
+      last    = j;
+    }
+
+  best_lg        = minimum;
+  best_chemin[0] = 0;
+  for (int etape = nbVilles - 1; etape >= 1; etape--) {
+    best_chemin[etape]  = last + 1;
+    const unsigned prev = S & ~(1U << last);
+
+    for (int i = 0; i < m; i++)
+      if ((prev & (1U << i)) &&
+          cout (prev, i) + distance[i + 1][last + 1] == cout (S, last)) {
+        last = i;
+        break;
+      }
+    S = prev;
+  }
+
+#undef cout
+
+  free (layer);
+  free (cout);
+}
+
+int tsp_compute_heldkarp (unsigned nb_iter)
+{
+  for (int step = 1; step <= nb_iter; step++) {
+
+    initialisation ();
+    tsp_heldkarp ();
+    afficher_minimum ();
+  }
+  return 0;
+}
@@ -13,6 +13,19 @@ __kernel void scrollup_ocl (__global unsigned *in, __global unsigned *out)
   out [y * DIM + x] = couleur;
 }
 
+// ring holds the original picture, base is the ring row displayed at the top
+__kernel void scrollup_ocl_ring (__global unsigned *ring, __global unsigned *out, unsigned base)
+{
+  unsigned y = get_global_id (1);
+  unsigned x = get_global_id (0);
+  unsigned ysource = y + base;
+
+  if (ysource >= DIM)
+    ysource -= DIM;
+
+  out [y * DIM + x] = ring [ysource * DIM + x];
+}
+
 __kernel void scrollup_ocl_ouf (__global unsigned *ina, __global unsigned *inb, __global unsigned *out, __global unsigned *mask, unsigned framecolor)
 {
   unsigned y = get_global_id (1);
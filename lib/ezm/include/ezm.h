@@ -61,6 +61,9 @@ void ezm_recorder_store_img2d_dim (ezm_recorder_t rec, unsigned width,
 void ezm_recorder_store_data_palette (ezm_recorder_t rec,
                                       ezv_palette_name_t pal);
 void ezm_recorder_declare_task_ids (ezm_recorder_t rec, char *task_ids[]);
+void ezm_recorder_store_clock_sync (ezm_recorder_t rec, unsigned rank,
+                                    uint64_t clock);
+void ezm_recorder_store_mpi_lane (ezm_recorder_t rec, unsigned lane);
 
 // helpers
 void ezm_helper_add_perfmeter (ezm_recorder_t rec, ezv_ctx_t ctx[],
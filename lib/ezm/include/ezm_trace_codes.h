@@ -22,6 +22,8 @@
 #define TRACE_PATCH_EXT    0x112
 #define TRACE_TILE_MIN     0x113
 #define TRACE_PATCH_MIN    0x114
+#define TRACE_CLOCK_SYNC   0x115
+#define TRACE_MPI_LANE     0x116
 
 
 #endif
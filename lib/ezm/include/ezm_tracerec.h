@@ -46,5 +46,8 @@ void ezm_tracerec_store_img2d_dim (ezm_tracerec_t rec, unsigned width,
 void ezm_tracerec_store_data_palette (ezm_tracerec_t rec,
                                       ezv_palette_name_t pal);
 void ezm_tracerec_declare_task_ids (ezm_tracerec_t rec, char *task_ids[]);
+void ezm_tracerec_store_clock_sync (ezm_tracerec_t rec, unsigned rank,
+                                    uint64_t clock);
+void ezm_tracerec_store_mpi_lane (ezm_tracerec_t rec, unsigned lane);
 
 #endif
@@ -5,7 +5,8 @@
 typedef enum {
     TASK_TYPE_COMPUTE,
     TASK_TYPE_WRITE,
-    TASK_TYPE_READ
+    TASK_TYPE_READ,
+    TASK_TYPE_MPI_WAIT
 } task_type_t;
 
 
@@ -324,6 +324,10 @@ void ezm_1D_ext (ezm_recorder_t rec, uint64_t start_time, uint64_t end_time,
   }
 #endif
 
+  // Time spent waiting for MPI communications is not accounted as work
+  if (task_type == TASK_TYPE_MPI_WAIT)
+    return;
+
   if (rec->time_needed)
     clock = ezm_gettime ();
 
@@ -421,6 +425,10 @@ void ezm_2D_ext (ezm_recorder_t rec, uint64_t start_time, uint64_t end_time,
   }
 #endif
 
+  // Time spent waiting for MPI communications is not accounted as work
+  if (task_type == TASK_TYPE_MPI_WAIT)
+    return;
+
   if (rec->time_needed)
     clock = ezm_gettime ();
 
@@ -485,6 +493,23 @@ void ezm_recorder_declare_task_ids (ezm_recorder_t rec, char *task_ids[])
 #endif
 }
 
+void ezm_recorder_store_clock_sync (ezm_recorder_t rec, unsigned rank,
+                                    uint64_t clock)
+{
+#ifdef ENABLE_TRACE
+  if (rec->tracerec)
+    ezm_tracerec_store_clock_sync (rec->tracerec, rank, clock);
+#endif
+}
+
+void ezm_recorder_store_mpi_lane (ezm_recorder_t rec, unsigned lane)
+{
+#ifdef ENABLE_TRACE
+  if (rec->tracerec)
+    ezm_tracerec_store_mpi_lane (rec->tracerec, lane);
+#endif
+}
+
 // Helpers
 void ezm_helper_add_perfmeter (ezm_recorder_t rec, ezv_ctx_t ctx[],
                                unsigned *nb_ctx)
@@ -97,6 +97,20 @@ void ezm_tracerec_declare_task_ids (ezm_tracerec_t rec, char *task_ids[])
       FUT_DO_PROBESTR (TRACE_TASKID, task_ids[i]); // task id i + 1
 }
 
+// Local date at which all processes of a multi-process run left a common
+// barrier: used to align the clocks of the per-process traces
+void ezm_tracerec_store_clock_sync (ezm_tracerec_t rec, unsigned rank,
+                                    uint64_t clock)
+{
+  FUT_DO_PROBE2 (TRACE_CLOCK_SYNC, rank, clock);
+}
+
+// Lane dedicated to MPI communications
+void ezm_tracerec_store_mpi_lane (ezm_tracerec_t rec, unsigned lane)
+{
+  FUT_DO_PROBE1 (TRACE_MPI_LANE, lane);
+}
+
 void ezm_tracerec_it_start (ezm_tracerec_t rec)
 {
   FUT_DO_PROBE0 (TRACE_BEGIN_ITER);
@@ -22,11 +22,14 @@
 #define TRACE_PATCH_EXT    0x112
 #define TRACE_TILE_MIN     0x113
 #define TRACE_PATCH_MIN    0x114
+#define TRACE_CLOCK_SYNC   0x115
+#define TRACE_MPI_LANE     0x116
 
 typedef enum {
     TASK_TYPE_COMPUTE,
     TASK_TYPE_WRITE,
-    TASK_TYPE_READ
+    TASK_TYPE_READ,
+    TASK_TYPE_MPI_WAIT
 } task_type_t;
 
 #define INT_COMBINE(low,high) ((unsigned long)(low) | ((unsigned long)(high) << 32))
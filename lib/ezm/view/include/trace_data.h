@@ -49,6 +49,16 @@ typedef struct
   unsigned task_ids_count;
   struct list_head *per_cpu;
   trace_iteration_t *iteration;
+  // multi-process runs
+  unsigned rank;
+  unsigned has_clock_sync;
+  uint64_t clock_sync;
+  int mpi_lane; // lane displaying MPI communications (-1 if none)
+  unsigned nb_ranks;
+  // merged traces only: rank of each lane, and cpu of each lane within its
+  // rank (-1 for MPI lanes)
+  unsigned *lane_rank;
+  int *lane_cpu;
 } trace_t;
 
 #define MAX_TRACES 2
@@ -56,6 +66,7 @@ typedef struct
 extern trace_t trace[MAX_TRACES];
 extern unsigned nb_traces;
 extern unsigned trace_data_align_mode;
+extern unsigned trace_data_keep_gaps;
 
 void trace_data_init (trace_t *tr, unsigned num);
 void trace_data_set_nb_threads (trace_t *tr, unsigned nb_cores,
@@ -66,6 +77,8 @@ void trace_data_set_first_iteration (trace_t *tr, unsigned it);
 void trace_data_set_label (trace_t *tr, char *label);
 void trace_data_set_meshfile (trace_t *tr, char *filename);
 void trace_data_set_palette (trace_t *tr, ezv_palette_name_t palette);
+void trace_data_set_clock_sync (trace_t *tr, unsigned rank, uint64_t clock);
+void trace_data_set_mpi_lane (trace_t *tr, unsigned lane);
 
 void trace_data_alloc_task_ids (trace_t *tr, unsigned count);
 void trace_data_add_taskid (trace_t *tr, char *id);
@@ -83,6 +96,11 @@ void trace_data_no_more_data (trace_t *tr);
 
 void trace_data_sync_iterations (void);
 
+void trace_data_merge (trace_t *tr, unsigned num, trace_t *ranks,
+                       unsigned nb);
+
+int trace_data_is_mpi_lane (trace_t *tr, unsigned lane);
+
 void trace_data_finalize (void);
 
 #define for_all_tasks(tr, cpu, var)                                            \
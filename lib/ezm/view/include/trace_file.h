@@ -4,5 +4,6 @@
 #include "trace_data.h"
 
 void trace_file_load  (char *file);
+void trace_file_load_merged (char *files[], unsigned nb);
 
 #endif
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -19,6 +20,7 @@ static int WINDOW_PREFERRED_HEIGHT = 1024;
 static int first_iteration = -1;
 static int last_iteration  = -1;
 static int whole_trace     = 0;
+static int merge_mode      = 0;
 
 static unsigned nb_dir      = 0;
 char *trace_dir[MAX_TRACES] = {NULL, NULL};
@@ -33,6 +35,8 @@ static void usage (char *progname, int val)
   fprintf (stderr, "\t-d\t| --dir <dir>\t\t: specify trace directory\n");
   fprintf (stderr, "\t-h\t| --help\t\t: display help\n");
   fprintf (stderr, "\t-i\t| --iteration <i>\t: display iteration i\n");
+  fprintf (stderr,
+           "\t-m\t| --merge\t\t: merge traces of MPI processes\n");
   fprintf (stderr, "\t-nt\t| --no-thumb\t\t: ignore thumbnails\n");
   fprintf (stderr, "\t-p\t| --params\t\t: use options from params.txt file\n");
   fprintf (stderr,
@@ -62,6 +66,8 @@ static char **filter_args (int *argc, char *argv[])
       (*argc)--;
       argv++;
       brightness = atoi (*argv);
+    } else if (!strcmp (*argv, "--merge") || !strcmp (*argv, "-m")) {
+      merge_mode = 1;
     } else if (!strcmp (*argv, "--whole-trace") || !strcmp (*argv, "-w")) {
       whole_trace = 1;
     } else if (!strcmp (*argv, "--help") || !strcmp (*argv, "-h")) {
@@ -170,10 +176,8 @@ static void check_consistency (void)
   }
 }
 
-int main (int argc, char **argv)
+static void load_traces (int argc, char **argv)
 {
-  argv = filter_args (&argc, argv);
-
   switch (argc) {
   case 0: {
     char file[1024];
@@ -200,6 +204,48 @@ int main (int argc, char **argv)
   default:
     exit_with_error ("Too many trace files specified (max %d)", MAX_TRACES);
   }
+}
+
+// Traces of MPI runs are named ezv_trace_current.<rank>.evt
+static void load_merged_traces (int argc, char **argv)
+{
+  if (argc > 0) {
+    trace_file_load_merged (argv, argc);
+    return;
+  }
+
+  char **files = NULL;
+  unsigned nb  = 0;
+
+  for (;;) {
+    char file[1024];
+
+    sprintf (file, "%s/ezv_trace_current.%d.evt", trace_dir[0], nb);
+    if (access (file, R_OK) == -1)
+      break;
+
+    files       = realloc (files, (nb + 1) * sizeof (char *));
+    files[nb++] = strdup (file);
+  }
+
+  if (nb == 0)
+    exit_with_error ("No MPI trace found in %s", trace_dir[0]);
+
+  trace_file_load_merged (files, nb);
+
+  for (int r = 0; r < nb; r++)
+    free (files[r]);
+  free (files);
+}
+
+int main (int argc, char **argv)
+{
+  argv = filter_args (&argc, argv);
+
+  if (merge_mode)
+    load_merged_traces (argc, argv);
+  else
+    load_traces (argc, argv);
 
   check_consistency ();
   
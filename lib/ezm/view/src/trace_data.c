@@ -14,6 +14,7 @@
 trace_t trace[MAX_TRACES];
 unsigned nb_traces             = 0;
 unsigned trace_data_align_mode = 0;
+unsigned trace_data_keep_gaps  = 0;
 
 #define REMOVE_OVERHEAD
 
@@ -52,6 +53,13 @@ void trace_data_init (trace_t *tr, unsigned num)
   tr->task_ids        = NULL;
   tr->task_ids_count  = 0;
   tr->has_cache_data  = 0;
+  tr->rank            = 0;
+  tr->has_clock_sync  = 0;
+  tr->clock_sync      = 0;
+  tr->mpi_lane        = -1;
+  tr->nb_ranks        = 1;
+  tr->lane_rank       = NULL;
+  tr->lane_cpu        = NULL;
 }
 
 void trace_data_set_nb_threads (trace_t *tr, unsigned nb_cores, unsigned nb_gpu)
@@ -95,12 +103,25 @@ void trace_data_set_palette (trace_t *tr, ezv_palette_name_t palette)
   tr->palette = palette;
 }
 
+void trace_data_set_clock_sync (trace_t *tr, unsigned rank, uint64_t clock)
+{
+  tr->rank           = rank;
+  tr->has_clock_sync = 1;
+  tr->clock_sync     = clock;
+}
+
+void trace_data_set_mpi_lane (trace_t *tr, unsigned lane)
+{
+  tr->mpi_lane = lane;
+}
+
 static int next_id[MAX_TRACES] = {0, 0};
 
 void trace_data_alloc_task_ids (trace_t *tr, unsigned count)
 {
   tr->task_ids       = calloc (count, sizeof (char *));
   tr->task_ids_count = count;
+  next_id[tr->num]   = 0;
 }
 
 void trace_data_add_taskid (trace_t *tr, char *id)
@@ -183,7 +204,8 @@ void trace_data_start_iteration (trace_t *tr, uint64_t start_time)
 
   // printf ("Iteration %d : start %lu -> ", tr->nb_iterations, start_time);
 #ifdef REMOVE_OVERHEAD
-  overhead += shift (start_time) - end_last_iteration - fixed_gap;
+  if (!trace_data_keep_gaps)
+    overhead += shift (start_time) - end_last_iteration - fixed_gap;
 #endif
 
   current_it                 = malloc (sizeof (trace_iteration_t));
@@ -345,4 +367,140 @@ void trace_data_sync_iterations (void)
   for (int it = min_it; it < trace[remaining].nb_iterations; it++) {
     trace[remaining].iteration[it].correction = cur_correction[remaining];
   }
-}
\ No newline at end of file
+}
+
+static int compare_ranks (const void *a, const void *b)
+{
+  return (int)((const trace_t *)a)->rank - (int)((const trace_t *)b)->rank;
+}
+
+// Merge the traces of several processes into 'tr': lanes of process r are
+// placed after those of process r - 1, and dates are expressed in the time
+// base of the first process thanks to the clock synchronization point.
+// Source traces are left in an unusable state.
+void trace_data_merge (trace_t *tr, unsigned num, trace_t *ranks, unsigned nb)
+{
+  unsigned nb_lanes = 0;
+  unsigned nb_it    = ranks[0].nb_iterations;
+  int64_t offset[nb];
+
+  for (int r = 0; r < nb; r++) {
+    if (!ranks[r].has_clock_sync)
+      exit_with_error ("Trace #%d has no clock synchronization point (traces "
+                       "must come from an MPI run)",
+                       r);
+    if (ranks[r].nb_gpu)
+      exit_with_error ("Merging traces with GPU lanes is not supported");
+  }
+
+  qsort (ranks, nb, sizeof (trace_t), compare_ranks);
+
+  for (int r = 0; r < nb; r++) {
+    if (ranks[r].nb_iterations != ranks[0].nb_iterations)
+      fprintf (stderr,
+               "Warning: process %d recorded %d iterations (vs %d for process "
+               "%d)\n",
+               ranks[r].rank, ranks[r].nb_iterations, ranks[0].nb_iterations,
+               ranks[0].rank);
+    nb_it     = min (nb_it, ranks[r].nb_iterations);
+    offset[r] = (int64_t)ranks[0].clock_sync - (int64_t)ranks[r].clock_sync;
+    nb_lanes += ranks[r].nb_cores;
+  }
+
+  // Label, dimensions, mesh, task ids, etc. are inherited from first process
+  *tr          = ranks[0];
+  tr->num      = num;
+  tr->nb_cores = nb_lanes;
+  tr->nb_gpu   = 0;
+  tr->nb_ranks = nb;
+  for (int r = 1; r < nb; r++)
+    tr->has_cache_data &= ranks[r].has_cache_data;
+
+  tr->nb_iterations = nb_it;
+  tr->per_cpu       = malloc (nb_lanes * sizeof (struct list_head));
+  tr->iteration     = malloc (nb_it * sizeof (trace_iteration_t));
+  tr->lane_rank     = malloc (nb_lanes * sizeof (unsigned));
+  tr->lane_cpu      = malloc (nb_lanes * sizeof (int));
+  tr->mpi_lane      = -1;
+
+  for (int it = 0; it < nb_it; it++) {
+    trace_iteration_t *iter = tr->iteration + it;
+
+    iter->start_time     = UINT64_MAX;
+    iter->end_time       = 0;
+    iter->correction     = 0;
+    iter->gap            = 0;
+    iter->first_cpu_task = calloc (nb_lanes, sizeof (trace_task_t *));
+#ifdef ENABLE_PER_ITERATION_STATS
+    iter->perfcounter_cpu_scores =
+        tr->has_cache_data ? calloc (nb_lanes, sizeof (perfcounter_array_t))
+                           : NULL;
+    for (int i = 0; i < EASYPAP_NB_COUNTERS; i++)
+      iter->perfcounter_scores[i] = 0;
+#endif
+  }
+
+  for (int r = 0, lane = 0; r < nb; r++) {
+    trace_t *src = ranks + r;
+
+    for (int it = 0; it < nb_it; it++) {
+      trace_iteration_t *iter = tr->iteration + it;
+
+      iter->start_time = min (iter->start_time,
+                              src->iteration[it].start_time + offset[r]);
+      iter->end_time =
+          max (iter->end_time, src->iteration[it].end_time + offset[r]);
+#ifdef ENABLE_PER_ITERATION_STATS
+      if (tr->has_cache_data)
+        for (int i = 0; i < EASYPAP_NB_COUNTERS; i++)
+          iter->perfcounter_scores[i] +=
+              src->iteration[it].perfcounter_scores[i];
+#endif
+    }
+
+    for (int c = 0; c < src->nb_cores; c++, lane++) {
+      tr->lane_rank[lane] = src->rank;
+      tr->lane_cpu[lane]  = (c == src->mpi_lane) ? -1 : c;
+
+      for (int it = 0; it < nb_it; it++) {
+        trace_task_t *first = src->iteration[it].first_cpu_task[c];
+
+        // Tasks of iterations not recorded by all processes are dropped
+        if (first != NULL && first->iteration < nb_it)
+          tr->iteration[it].first_cpu_task[lane] = first;
+#ifdef ENABLE_PER_ITERATION_STATS
+        if (tr->has_cache_data)
+          for (int i = 0; i < EASYPAP_NB_COUNTERS; i++)
+            tr->iteration[it].perfcounter_cpu_scores[lane][i] =
+                src->iteration[it].perfcounter_cpu_scores[c][i];
+#endif
+      }
+
+      INIT_LIST_HEAD (tr->per_cpu + lane);
+
+      list_for_each_entry_safe (trace_task_t, t, src->per_cpu + c, cpu_chain)
+      {
+        list_del (&t->cpu_chain);
+        if (t->iteration < nb_it) {
+          t->start_time += offset[r];
+          t->end_time += offset[r];
+          list_add_tail (&t->cpu_chain, tr->per_cpu + lane);
+        } else
+          free (t);
+      }
+    }
+
+    for (int it = 0; it < src->nb_iterations; it++)
+      free (src->iteration[it].first_cpu_task);
+    free (src->iteration);
+    free (src->per_cpu);
+  }
+}
+
+int trace_data_is_mpi_lane (trace_t *tr, unsigned lane)
+{
+  if (tr->lane_cpu != NULL)
+    return tr->lane_cpu[lane] == -1;
+
+  return (int)lane == tr->mpi_lane;
+}
@@ -19,7 +19,7 @@
 static long *last_start_times = NULL;
 static unsigned current_iteration;
 
-void trace_file_load (char *file)
+static void load_trace (trace_t *tr, unsigned num, char *file)
 {
   fxt_t fxt;
   fxt_blockev_t evs;
@@ -32,7 +32,7 @@ void trace_file_load (char *file)
 
   current_iteration = 0;
 
-  trace_data_init (&trace[nb_traces], nb_traces);
+  trace_data_init (tr, num);
 
   evs = fxt_blockev_enter (fxt);
 
@@ -43,11 +43,11 @@ void trace_file_load (char *file)
 
     switch (ev.code) {
     case TRACE_BEGIN_ITER:
-      trace_data_start_iteration (&trace[nb_traces], ev.time / 1000);
+      trace_data_start_iteration (tr, ev.time / 1000);
       break;
 
     case TRACE_END_ITER:
-      trace_data_end_iteration (&trace[nb_traces], ev.time / 1000);
+      trace_data_end_iteration (tr, ev.time / 1000);
       current_iteration++;
       break;
 
@@ -61,7 +61,7 @@ void trace_file_load (char *file)
       last_start_times = malloc ((nc + ng) * sizeof (long));
       for (int c = 0; c < nc + ng; c++)
         last_start_times[c] = 0;
-      trace_data_set_nb_threads (&trace[nb_traces], nc, ng);
+      trace_data_set_nb_threads (tr, nc, ng);
       break;
     }
 
@@ -70,15 +70,15 @@ void trace_file_load (char *file)
       break;
 
     case TRACE_END_TILE:
-      if (trace[nb_traces].has_cache_data) {
+      if (tr->has_cache_data) {
         assert (ev.nb_params > 7);
         trace_data_add_task (
-            &trace[nb_traces], last_start_times[cpu], ev.param[0], ev.param[2],
+            tr, last_start_times[cpu], ev.param[0], ev.param[2],
             ev.param[3], ev.param[4], ev.param[5], current_iteration, cpu,
             INT_EXTRACT_LOW (ev.param[6]), INT_EXTRACT_HIGH (ev.param[6]),
             (int64_t *)ev.param + 7);
       } else
-        trace_data_add_task (&trace[nb_traces], last_start_times[cpu],
+        trace_data_add_task (tr, last_start_times[cpu],
                              ev.param[0], ev.param[2], ev.param[3], ev.param[4],
                              ev.param[5], current_iteration, cpu,
                              INT_EXTRACT_LOW (ev.param[6]),
@@ -86,17 +86,17 @@ void trace_file_load (char *file)
       break;
 
     case TRACE_TILE:
-      if (trace[nb_traces].has_cache_data) {
+      if (tr->has_cache_data) {
         assert (ev.nb_params > 5);
         trace_data_add_task (
-            &trace[nb_traces], ev.param[0], ev.time / 1000,
+            tr, ev.param[0], ev.time / 1000,
             INT_EXTRACT_LOW (ev.param[2]), INT_EXTRACT_HIGH (ev.param[2]),
             INT_EXTRACT_LOW (ev.param[3]), INT_EXTRACT_HIGH (ev.param[3]),
             current_iteration, cpu, INT_EXTRACT_LOW (ev.param[4]),
             INT_EXTRACT_HIGH (ev.param[4]), (int64_t *)ev.param + 5);
       } else
         trace_data_add_task (
-            &trace[nb_traces], ev.param[0], ev.time / 1000,
+            tr, ev.param[0], ev.time / 1000,
             INT_EXTRACT_LOW (ev.param[2]), INT_EXTRACT_HIGH (ev.param[2]),
             INT_EXTRACT_LOW (ev.param[3]), INT_EXTRACT_HIGH (ev.param[3]),
             current_iteration, cpu, INT_EXTRACT_LOW (ev.param[4]),
@@ -105,7 +105,7 @@ void trace_file_load (char *file)
 
     case TRACE_TILE_EXT:
       trace_data_add_task (
-          &trace[nb_traces], ev.param[0], ev.param[2],
+          tr, ev.param[0], ev.param[2],
           INT_EXTRACT_LOW (ev.param[3]), INT_EXTRACT_HIGH (ev.param[3]),
           INT_EXTRACT_LOW (ev.param[4]), INT_EXTRACT_HIGH (ev.param[4]),
           current_iteration, cpu, INT_EXTRACT_LOW (ev.param[5]),
@@ -114,14 +114,14 @@ void trace_file_load (char *file)
 
     case TRACE_TILE_MIN:
         trace_data_add_task (
-            &trace[nb_traces], ev.param[0], ev.time / 1000,
+            tr, ev.param[0], ev.time / 1000,
             INT_EXTRACT_LOW (ev.param[2]), INT_EXTRACT_HIGH (ev.param[2]),
             INT_EXTRACT_LOW (ev.param[3]), INT_EXTRACT_HIGH (ev.param[3]),
             current_iteration, cpu, TASK_TYPE_COMPUTE, 0, NULL);
       break;
 
     case TRACE_PATCH:
-      trace_data_add_task (&trace[nb_traces], ev.param[0], ev.time / 1000,
+      trace_data_add_task (tr, ev.param[0], ev.time / 1000,
                            INT_EXTRACT_LOW (ev.param[2]), 0,
                            INT_EXTRACT_HIGH (ev.param[2]), 0, current_iteration,
                            cpu, INT_EXTRACT_LOW (ev.param[3]),
@@ -129,7 +129,7 @@ void trace_file_load (char *file)
       break;
 
     case TRACE_PATCH_EXT:
-      trace_data_add_task (&trace[nb_traces], ev.param[0], ev.param[2],
+      trace_data_add_task (tr, ev.param[0], ev.param[2],
                            INT_EXTRACT_LOW (ev.param[3]), 0,
                            INT_EXTRACT_HIGH (ev.param[3]), 0, current_iteration,
                            cpu, INT_EXTRACT_LOW (ev.param[4]),
@@ -137,42 +137,50 @@ void trace_file_load (char *file)
       break;
 
     case TRACE_PATCH_MIN:
-      trace_data_add_task (&trace[nb_traces], ev.param[0], ev.time / 1000,
+      trace_data_add_task (tr, ev.param[0], ev.time / 1000,
                            INT_EXTRACT_LOW (ev.param[2]), 0,
                            INT_EXTRACT_HIGH (ev.param[2]), 0, current_iteration,
                            cpu, TASK_TYPE_COMPUTE, 0, NULL);
       break;
 
     case TRACE_DIM:
-      trace_data_set_dim (&trace[nb_traces], ev.param[0]);
+      trace_data_set_dim (tr, ev.param[0]);
       break;
 
     case TRACE_FIRST_ITER:
-      trace_data_set_first_iteration (&trace[nb_traces], ev.param[0]);
+      trace_data_set_first_iteration (tr, ev.param[0]);
       break;
 
     case TRACE_LABEL:
-      trace_data_set_label (&trace[nb_traces], (char *)ev.raw);
+      trace_data_set_label (tr, (char *)ev.raw);
       break;
 
     case TRACE_TASKID_COUNT:
-      trace_data_alloc_task_ids (&trace[nb_traces], ev.param[0]);
+      trace_data_alloc_task_ids (tr, ev.param[0]);
       break;
 
     case TRACE_TASKID:
-      trace_data_add_taskid (&trace[nb_traces], (char *)ev.raw);
+      trace_data_add_taskid (tr, (char *)ev.raw);
       break;
 
     case TRACE_DO_CACHE:
-      trace_data_set_do_cache (&trace[nb_traces], (unsigned)ev.param[0]);
+      trace_data_set_do_cache (tr, (unsigned)ev.param[0]);
       break;
 
     case TRACE_MESHFILE:
-      trace_data_set_meshfile (&trace[nb_traces], (char *)ev.raw);
+      trace_data_set_meshfile (tr, (char *)ev.raw);
       break;
 
     case TRACE_PALETTE:
-      trace_data_set_palette (&trace[nb_traces], ev.param[0]);
+      trace_data_set_palette (tr, ev.param[0]);
+      break;
+
+    case TRACE_CLOCK_SYNC:
+      trace_data_set_clock_sync (tr, ev.param[0], ev.param[1]);
+      break;
+
+    case TRACE_MPI_LANE:
+      trace_data_set_mpi_lane (tr, ev.param[0]);
       break;
     default:
       break;
@@ -189,16 +197,21 @@ void trace_file_load (char *file)
   last_start_times = NULL;
 
   // Set a default label
-  if (trace[nb_traces].label == NULL) {
+  if (tr->label == NULL) {
     char *name    = basename (file);
     char *lastdot = strrchr (name, '.');
     if (lastdot != NULL)
       *lastdot = '\0';
 
-    trace_data_set_label (&trace[nb_traces], name);
+    trace_data_set_label (tr, name);
   }
 
-  trace_data_no_more_data (&trace[nb_traces]);
+  trace_data_no_more_data (tr);
+}
+
+void trace_file_load (char *file)
+{
+  load_trace (&trace[nb_traces], nb_traces, file);
 
   printf ("Trace #%d \"%s\" successfully opened: %d iterations on %d CPUs "
           "%s"
@@ -211,3 +224,28 @@ void trace_file_load (char *file)
 
   nb_traces++;
 }
+
+// Load the traces of a multi-process run and merge them into a single trace,
+// in which each process appears as a group of lanes
+void trace_file_load_merged (char *files[], unsigned nb)
+{
+  trace_t *ranks = malloc (nb * sizeof (trace_t));
+
+  // Idle time between iterations is not removed, otherwise each process
+  // would be shifted by a different amount
+  trace_data_keep_gaps = 1;
+
+  for (int r = 0; r < nb; r++)
+    load_trace (ranks + r, nb_traces, files[r]);
+
+  trace_data_merge (&trace[nb_traces], nb_traces, ranks, nb);
+
+  printf ("Trace #%d \"%s\" successfully merged: %d iterations on %d "
+          "processes (%d CPUs)\n",
+          nb_traces, trace[nb_traces].label, trace[nb_traces].nb_iterations,
+          nb, trace[nb_traces].nb_cores);
+
+  free (ranks);
+
+  nb_traces++;
+}
@@ -822,7 +822,16 @@ static void create_cpu_textures (TTF_Font *font)
           is_lane = 1;
         } else
           snprintf (msg, 32, "GPU %2d ", gpu);
-      } else
+      } else if (trace[t].lane_rank != NULL) {
+        // merged MPI trace: lanes are grouped by process
+        if (trace_data_is_mpi_lane (trace + t, c))
+          snprintf (msg, 32, "P%d MPI ", trace[t].lane_rank[c]);
+        else
+          snprintf (msg, 32, "P%d C%2d ", trace[t].lane_rank[c],
+                    trace[t].lane_cpu[c]);
+      } else if (trace_data_is_mpi_lane (trace + t, c))
+        snprintf (msg, 32, "MPI    ");
+      else
         snprintf (msg, 32, "CPU %2d ", c);
 
       blit_on_surface (surface, font, t, c, msg, trace_cpu_color (c));
@@ -1455,6 +1464,11 @@ static void trace_graphics_display_trace (unsigned _t,
             dst.h = TASK_HEIGHT / 2;
             if (t->task_type == TASK_TYPE_READ)
               dst.y += TASK_HEIGHT / 2;
+          } else if (t->task_type == TASK_TYPE_MPI_WAIT &&
+                     !trace_data_is_mpi_lane (tr, c)) {
+            // MPI waiting time: thin bar at the bottom of the CPU row
+            dst.h = TASK_HEIGHT / 4;
+            dst.y += TASK_HEIGHT - dst.h;
           }
 
           // Check if mouse is within the bounds of the gantt zone
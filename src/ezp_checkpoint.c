@@ -0,0 +1,237 @@
+#include "ezp_checkpoint.h"
+#include "api_funcs.h"
+#include "debug.h"
+#include "error.h"
+#include "global.h"
+#include "hooks.h"
+#include "img_data.h"
+#include "mesh_data.h"
+
+#include <inttypes.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif
+
+unsigned checkpoint_period = 0;
+char *restart_file         = NULL;
+
+#define CKPT_MAGIC "EZPCKPT"
+#define CKPT_VERSION 1
+#define CKPT_HEADER_SIZE 512
+
+// The state is stored as one flat array, independently of the way it was
+// distributed among processes: a checkpoint written by N processes can be
+// reloaded by M processes.
+#define CKPT_LAYOUT_FLAT 0
+
+typedef struct
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t layout;
+  uint32_t dim;
+  uint32_t nb_cells;
+  uint32_t tile_w;
+  uint32_t tile_h;
+  uint32_t iteration;
+  uint32_t nb_procs;
+  uint64_t state_size;
+  char kernel[64];
+  char variant[64];
+} ckpt_header_t;
+
+_Static_assert (sizeof (ckpt_header_t) <= CKPT_HEADER_SIZE,
+                "checkpoint header too large");
+
+static void get_region (ezp_ckpt_region_t *r)
+{
+  if (the_checkpoint != NULL) {
+    r->base   = NULL;
+    r->offset = 0;
+    r->size   = 0;
+    r->total  = 0;
+    the_checkpoint (r);
+  } else {
+    if (easypap_mode == EASYPAP_MODE_2D_IMAGES) {
+      r->base  = image;
+      r->total = DIM * DIM * sizeof (uint32_t);
+    } else {
+      r->base  = mesh_data;
+      r->total = NB_CELLS * sizeof (float);
+    }
+    r->offset = 0;
+    r->size   = r->total;
+  }
+
+  if (r->offset + r->size > r->total)
+    exit_with_error ("Checkpoint region [%zu, %zu) exceeds state size (%zu)",
+                     r->offset, r->offset + r->size, r->total);
+  if (r->size > INT_MAX)
+    exit_with_error ("Checkpoint region too large (%zu bytes)", r->size);
+}
+
+static void fill_header (ckpt_header_t *h, unsigned iteration, size_t total)
+{
+  memset (h, 0, sizeof (*h));
+  memcpy (h->magic, CKPT_MAGIC, sizeof (CKPT_MAGIC));
+  h->version    = CKPT_VERSION;
+  h->layout     = CKPT_LAYOUT_FLAT;
+  h->dim        = DIM;
+  h->nb_cells   = NB_CELLS;
+  h->tile_w     = TILE_W;
+  h->tile_h     = TILE_H;
+  h->iteration  = iteration;
+  h->nb_procs   = easypap_mpi_size ();
+  h->state_size = total;
+  snprintf (h->kernel, sizeof (h->kernel), "%s", kernel_name);
+  snprintf (h->variant, sizeof (h->variant), "%s", variant_name);
+}
+
+static void check_header (const ckpt_header_t *h, const char *filename,
+                          size_t total)
+{
+  if (memcmp (h->magic, CKPT_MAGIC, sizeof (CKPT_MAGIC)))
+    exit_with_error ("\"%s\" is not an easypap checkpoint", filename);
+  if (h->version != CKPT_VERSION || h->layout != CKPT_LAYOUT_FLAT)
+    exit_with_error ("Unsupported checkpoint version/layout (%u/%u)",
+                     h->version, h->layout);
+  if (strcmp (h->kernel, kernel_name))
+    exit_with_error ("Checkpoint was produced by kernel %s, not %s",
+                     h->kernel, kernel_name);
+  if (easypap_mode == EASYPAP_MODE_2D_IMAGES && h->dim != DIM)
+    exit_with_error ("Checkpoint was produced with DIM=%u (current: %u)",
+                     h->dim, DIM);
+  if (easypap_mode == EASYPAP_MODE_3D_MESHES && h->nb_cells != NB_CELLS)
+    exit_with_error ("Checkpoint was produced with %u cells (current: %u)",
+                     h->nb_cells, NB_CELLS);
+  if (h->state_size != total)
+    exit_with_error ("Checkpoint state size mismatch (%" PRIu64
+                     " bytes, expected %zu)",
+                     h->state_size, total);
+  if (strcmp (h->variant, variant_name))
+    PRINT_MASTER ("Warning: checkpoint was produced by variant %s\n",
+                  h->variant);
+}
+
+void ezp_checkpoint_save (const char *filename, unsigned iteration)
+{
+  char tmpname[PATH_MAX];
+  ezp_ckpt_region_t r;
+  ckpt_header_t h;
+
+  if (gpu_used)
+    exit_with_error ("Checkpointing is only supported by CPU variants");
+
+  get_region (&r);
+  fill_header (&h, iteration, r.total);
+
+  // Processes which all hold a full copy of the state (e.g. non-MPI variants)
+  // leave the writing to the master
+  if (r.size == r.total && !easypap_proc_is_master ())
+    r.size = 0;
+
+  snprintf (tmpname, PATH_MAX, "%s.tmp", filename);
+
+#ifdef ENABLE_MPI
+  if (easypap_mpirun) {
+    MPI_File fh;
+    MPI_Status status;
+
+    if (MPI_File_open (MPI_COMM_WORLD, tmpname,
+                       MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL,
+                       &fh) != MPI_SUCCESS)
+      exit_with_error ("Cannot create \"%s\" checkpoint file", tmpname);
+
+    MPI_File_set_size (fh, CKPT_HEADER_SIZE + r.total);
+
+    if (easypap_proc_is_master ())
+      MPI_File_write_at (fh, 0, &h, sizeof (h), MPI_BYTE, &status);
+
+    MPI_File_write_at_all (fh, CKPT_HEADER_SIZE + r.offset, r.base, r.size,
+                           MPI_BYTE, &status);
+    MPI_File_close (&fh);
+
+    // Make sure every process is done before the checkpoint replaces the
+    // previous one
+    MPI_Barrier (MPI_COMM_WORLD);
+  } else
+#endif
+  {
+    FILE *f = fopen (tmpname, "w");
+
+    if (f == NULL)
+      exit_with_error ("Cannot create \"%s\" checkpoint file (%s)", tmpname,
+                       strerror (errno));
+
+    fwrite (&h, sizeof (h), 1, f);
+    fseek (f, CKPT_HEADER_SIZE + r.offset, SEEK_SET);
+    if (fwrite (r.base, 1, r.size, f) != r.size)
+      exit_with_error ("Cannot write to \"%s\" file (%s)", tmpname,
+                       strerror (errno));
+    fclose (f);
+  }
+
+  if (easypap_proc_is_master ()) {
+    if (rename (tmpname, filename) == -1)
+      exit_with_error ("Cannot rename \"%s\" to \"%s\" (%s)", tmpname,
+                       filename, strerror (errno));
+    PRINT_DEBUG ('i', "Checkpoint of iteration %u stored in %s\n", iteration,
+                 filename);
+  }
+}
+
+unsigned ezp_checkpoint_restore (const char *filename)
+{
+  ezp_ckpt_region_t r;
+  ckpt_header_t h;
+
+  if (gpu_used)
+    exit_with_error ("Checkpointing is only supported by CPU variants");
+
+  get_region (&r);
+
+#ifdef ENABLE_MPI
+  if (easypap_mpirun) {
+    MPI_File fh;
+    MPI_Status status;
+
+    if (MPI_File_open (MPI_COMM_WORLD, filename, MPI_MODE_RDONLY,
+                       MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+      exit_with_error ("Cannot open \"%s\" checkpoint file", filename);
+
+    MPI_File_read_at_all (fh, 0, &h, sizeof (h), MPI_BYTE, &status);
+    check_header (&h, filename, r.total);
+
+    MPI_File_read_at_all (fh, CKPT_HEADER_SIZE + r.offset, r.base, r.size,
+                          MPI_BYTE, &status);
+    MPI_File_close (&fh);
+  } else
+#endif
+  {
+    FILE *f = fopen (filename, "r");
+
+    if (f == NULL)
+      exit_with_error ("Cannot open \"%s\" checkpoint file (%s)", filename,
+                       strerror (errno));
+
+    if (fread (&h, sizeof (h), 1, f) != 1)
+      exit_with_error ("Cannot read checkpoint header from \"%s\"", filename);
+    check_header (&h, filename, r.total);
+
+    fseek (f, CKPT_HEADER_SIZE + r.offset, SEEK_SET);
+    if (fread (r.base, 1, r.size, f) != r.size)
+      exit_with_error ("Truncated checkpoint file \"%s\"", filename);
+    fclose (f);
+  }
+
+  PRINT_MASTER ("Restarting from iteration %u (checkpoint written by %u "
+                "process(es))\n",
+                h.iteration, h.nb_procs);
+
+  return h.iteration;
+}
@@ -13,6 +13,10 @@
 #include "mesh_data.h"
 #include "monitoring.h"
 
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif
+
 ezm_recorder_t ezp_monitor = NULL;
 
 char easypap_trace_label[MAX_LABEL] = {0};
@@ -83,6 +87,16 @@ void ezp_monitoring_init (unsigned nb_cpus, unsigned nb_gpus)
       ezm_recorder_store_img2d_dim (ezp_monitor, DIM, DIM);
     }
 
+#ifdef ENABLE_MPI
+    // Processes leave the barrier (almost) simultaneously: their local dates
+    // are used to align the per-process traces when merging them
+    if (easypap_mpirun) {
+      MPI_Barrier (MPI_COMM_WORLD);
+      ezm_recorder_store_clock_sync (ezp_monitor, easypap_mpi_rank (),
+                                     ezp_gettime ());
+    }
+#endif
+
     if (trace_starting_iteration == 1)
       ezm_recorder_enable (ezp_monitor, 1);
 
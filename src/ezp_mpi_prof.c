@@ -0,0 +1,216 @@
+#include "ezp_mpi_prof.h"
+
+unsigned mpi_profiling = 0;
+
+#ifdef ENABLE_MPI
+
+#include "api_funcs.h"
+#include "error.h"
+#include "monitoring.h"
+
+#include <inttypes.h>
+#include <limits.h>
+#include <mpi.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *category_name[EZP_MPI_NB_CATEGORIES] = {"send", "recv",
+                                                           "wait", "coll"};
+
+// Statistics of the current iteration, and of the whole run
+static ezp_mpi_stat_t current[EZP_MPI_NB_CATEGORIES];
+static ezp_mpi_stat_t total[EZP_MPI_NB_CATEGORIES];
+
+static int trace_lane = -1;
+static FILE *csv      = NULL;
+
+static inline uint64_t nb_bytes (int count, MPI_Datatype type)
+{
+  int size = 0;
+
+  if (type != MPI_DATATYPE_NULL)
+    PMPI_Type_size (type, &size);
+
+  return (uint64_t)count * size;
+}
+
+// May be called concurrently by several threads (MPI_THREAD_MULTIPLE)
+static void record (ezp_mpi_category_t cat, uint64_t bytes, uint64_t start)
+{
+  uint64_t end = ezp_gettime ();
+
+  __atomic_fetch_add (&current[cat].calls, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add (&current[cat].bytes, bytes, __ATOMIC_RELAXED);
+  __atomic_fetch_add (&current[cat].time, end - start, __ATOMIC_RELAXED);
+
+  if (trace_lane != -1)
+    monitoring_mpi_wait (trace_lane, start, end);
+}
+
+void ezp_mpi_prof_init (int lane)
+{
+  char filename[PATH_MAX];
+
+  trace_lane = lane;
+  if (trace_lane != -1)
+    ezm_recorder_store_mpi_lane (ezp_monitor, trace_lane);
+
+  snprintf (filename, PATH_MAX, "data/perf/mpi_prof.%d.csv",
+            easypap_mpi_rank ());
+  csv = fopen (filename, "w");
+  if (csv == NULL)
+    exit_with_error ("Cannot create \"%s\" file (%s)", filename,
+                     strerror (errno));
+
+  fprintf (csv, "iteration");
+  for (int c = 0; c < EZP_MPI_NB_CATEGORIES; c++)
+    fprintf (csv, ";%s_calls;%s_bytes;%s_time", category_name[c],
+             category_name[c], category_name[c]);
+  fprintf (csv, "\n");
+}
+
+void ezp_mpi_prof_end_iteration (unsigned iteration)
+{
+  if (csv == NULL)
+    return;
+
+  fprintf (csv, "%u", iteration);
+  for (int c = 0; c < EZP_MPI_NB_CATEGORIES; c++) {
+    fprintf (csv, ";%" PRIu64 ";%" PRIu64 ";%" PRIu64, current[c].calls,
+             current[c].bytes, current[c].time);
+
+    total[c].calls += current[c].calls;
+    total[c].bytes += current[c].bytes;
+    total[c].time += current[c].time;
+    current[c].calls = current[c].bytes = current[c].time = 0;
+  }
+  fprintf (csv, "\n");
+}
+
+void ezp_mpi_prof_get_totals (uint64_t *msgs, uint64_t *bytes, uint64_t *time)
+{
+  uint64_t sent[2] = {total[EZP_MPI_SEND].calls, total[EZP_MPI_SEND].bytes};
+  uint64_t sum[2]  = {0, 0};
+  uint64_t t       = 0;
+
+  for (int c = 0; c < EZP_MPI_NB_CATEGORIES; c++)
+    t += total[c].time;
+
+  // PMPI calls are not recorded
+  PMPI_Reduce (sent, sum, 2, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+  PMPI_Reduce (&t, time, 1, MPI_UINT64_T, MPI_MAX, 0, MPI_COMM_WORLD);
+
+  *msgs  = sum[0];
+  *bytes = sum[1];
+}
+
+void ezp_mpi_prof_finalize (void)
+{
+  // Communications are no longer recorded (the trace recorder is about to be
+  // destroyed)
+  mpi_profiling = 0;
+  trace_lane    = -1;
+
+  if (csv != NULL) {
+    fclose (csv);
+    csv = NULL;
+  }
+}
+
+// PMPI wrappers
+
+#define PROFILED(cat, bytes, call)                                             \
+  do {                                                                         \
+    if (!mpi_profiling)                                                        \
+      return call;                                                             \
+    uint64_t _start = ezp_gettime ();                                          \
+    int _ret        = call;                                                    \
+    record ((cat), (bytes), _start);                                           \
+    return _ret;                                                               \
+  } while (0)
+
+int MPI_Send (const void *buf, int count, MPI_Datatype datatype, int dest,
+              int tag, MPI_Comm comm)
+{
+  PROFILED (EZP_MPI_SEND, nb_bytes (count, datatype),
+            PMPI_Send (buf, count, datatype, dest, tag, comm));
+}
+
+int MPI_Isend (const void *buf, int count, MPI_Datatype datatype, int dest,
+               int tag, MPI_Comm comm, MPI_Request *request)
+{
+  PROFILED (EZP_MPI_SEND, nb_bytes (count, datatype),
+            PMPI_Isend (buf, count, datatype, dest, tag, comm, request));
+}
+
+int MPI_Recv (void *buf, int count, MPI_Datatype datatype, int source, int tag,
+              MPI_Comm comm, MPI_Status *status)
+{
+  PROFILED (EZP_MPI_RECV, nb_bytes (count, datatype),
+            PMPI_Recv (buf, count, datatype, source, tag, comm, status));
+}
+
+int MPI_Irecv (void *buf, int count, MPI_Datatype datatype, int source,
+               int tag, MPI_Comm comm, MPI_Request *request)
+{
+  PROFILED (EZP_MPI_RECV, nb_bytes (count, datatype),
+            PMPI_Irecv (buf, count, datatype, source, tag, comm, request));
+}
+
+int MPI_Wait (MPI_Request *request, MPI_Status *status)
+{
+  PROFILED (EZP_MPI_WAIT, 0, PMPI_Wait (request, status));
+}
+
+int MPI_Waitall (int count, MPI_Request array_of_requests[],
+                 MPI_Status array_of_statuses[])
+{
+  PROFILED (EZP_MPI_WAIT, 0,
+            PMPI_Waitall (count, array_of_requests, array_of_statuses));
+}
+
+int MPI_Barrier (MPI_Comm comm)
+{
+  PROFILED (EZP_MPI_COLL, 0, PMPI_Barrier (comm));
+}
+
+int MPI_Bcast (void *buffer, int count, MPI_Datatype datatype, int root,
+               MPI_Comm comm)
+{
+  PROFILED (EZP_MPI_COLL, nb_bytes (count, datatype),
+            PMPI_Bcast (buffer, count, datatype, root, comm));
+}
+
+int MPI_Reduce (const void *sendbuf, void *recvbuf, int count,
+                MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm)
+{
+  PROFILED (EZP_MPI_COLL, nb_bytes (count, datatype),
+            PMPI_Reduce (sendbuf, recvbuf, count, datatype, op, root, comm));
+}
+
+int MPI_Allreduce (const void *sendbuf, void *recvbuf, int count,
+                   MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
+{
+  PROFILED (EZP_MPI_COLL, nb_bytes (count, datatype),
+            PMPI_Allreduce (sendbuf, recvbuf, count, datatype, op, comm));
+}
+
+int MPI_Iallreduce (const void *sendbuf, void *recvbuf, int count,
+                    MPI_Datatype datatype, MPI_Op op, MPI_Comm comm,
+                    MPI_Request *request)
+{
+  PROFILED (EZP_MPI_COLL, nb_bytes (count, datatype),
+            PMPI_Iallreduce (sendbuf, recvbuf, count, datatype, op, comm,
+                             request));
+}
+
+int MPI_Allgatherv (const void *sendbuf, int sendcount, MPI_Datatype sendtype,
+                    void *recvbuf, const int recvcounts[], const int displs[],
+                    MPI_Datatype recvtype, MPI_Comm comm)
+{
+  PROFILED (EZP_MPI_COLL, nb_bytes (sendcount, sendtype),
+            PMPI_Allgatherv (sendbuf, sendcount, sendtype, recvbuf,
+                             recvcounts, displs, recvtype, comm));
+}
+
+#endif
@@ -28,6 +28,7 @@ debug_2d_t the_2d_debug     = NULL;
 debug_1d_t the_1d_overlay   = NULL;
 debug_2d_t the_2d_overlay   = NULL;
 void_func_t the_send_data   = NULL;
+ckpt_func_t the_checkpoint  = NULL;
 
 static void_func_t the_refresh_img = NULL;
 static tile_func_t the_tile_func   = NULL;
@@ -223,6 +224,7 @@ void hooks_establish_bindings (int silent)
   the_draw        = bind_it (kernel_name, "draw", variant_name, 0);
   the_finalize    = bind_it (kernel_name, "finalize", variant_name, 0);
   the_refresh_img = bind_it (kernel_name, "refresh_img", variant_name, 0);
+  the_checkpoint  = bind_it (kernel_name, "checkpoint", variant_name, 0);
 
   if (easypap_mode == EASYPAP_MODE_2D_IMAGES) {
     the_tile_func  = bind_tile (kernel_name);
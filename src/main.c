@@ -7,7 +7,9 @@
 #ifdef ENABLE_SHA
 #include "hash.h"
 #endif
+#include "ezp_checkpoint.h"
 #include "ezp_ctx.h"
+#include "ezp_mpi_prof.h"
 #include "ezv_event.h"
 
 #include <fcntl.h>
@@ -46,6 +48,8 @@ unsigned easypap_mpirun                                        = 0;
 unsigned easypap_gl_buffer_sharing                             = 1;
 static int _easypap_mpi_rank                                   = 0;
 static int _easypap_mpi_size                                   = 1;
+static unsigned mpi_thread_multiple                            = 0;
+static int _easypap_mpi_thread_level __attribute__ ((unused))  = 0;
 static unsigned master_do_display __attribute__ ((unused))     = 1;
 static unsigned start_in_pause                                 = 0;
 static unsigned quit_when_done                                 = 0;
@@ -62,6 +66,8 @@ unsigned use_scotch                                            = 0;
 static unsigned data_sync_on_host                              = 1;
 static unsigned do_shuffle_cells                               = 0;
 static unsigned do_shuffle_partitions                          = 0;
+static unsigned restart_iteration                              = 0;
+static int64_t mpi_msgs = -1, mpi_bytes = -1, mpi_time = -1;
 
 static hwloc_topology_t topology;
 
@@ -75,9 +81,17 @@ unsigned easypap_requested_number_of_threads (void)
     return atoi (str);
 }
 
+// When communications are profiled, an extra trace lane is inserted after
+// CPU lanes to display them
+static unsigned mpi_prof_nb_lanes (void)
+{
+  return (easypap_mpirun && mpi_profiling && trace_may_be_used) ? 1 : 0;
+}
+
 unsigned easypap_gpu_lane (unsigned gpu_no)
 {
-  return easypap_requested_number_of_threads () + gpu_no;
+  return easypap_requested_number_of_threads () + mpi_prof_nb_lanes () +
+         gpu_no;
 }
 
 char *easypap_omp_schedule (void)
@@ -107,6 +121,15 @@ int easypap_mpi_size (void)
   return _easypap_mpi_size;
 }
 
+int easypap_mpi_thread_multiple (void)
+{
+#ifdef ENABLE_MPI
+  return easypap_mpirun && _easypap_mpi_thread_level >= MPI_THREAD_MULTIPLE;
+#else
+  return 0;
+#endif
+}
+
 int easypap_proc_is_master (void)
 {
   // easypap_mpi_rank == 0 even if !easypap_mpirun
@@ -156,37 +179,69 @@ static void update_refresh_rate (int p)
   printf ("< Refresh rate set to: %d >\n", refresh_rate);
 }
 
-static void output_perf_numbers (long time_in_us, unsigned nb_iter,
-                                 int64_t total_cycles, int64_t total_stalls)
+// When 'with_mpi' is set, MPI communication totals are appended to the
+// regular columns
+static void write_perf_numbers (const char *filename, int with_mpi,
+                                long time_in_us, unsigned nb_iter,
+                                int64_t total_cycles, int64_t total_stalls)
 {
-  FILE *f = fopen (output_file, "a");
+  FILE *f = fopen (filename, "a");
   struct utsname s;
 
   if (f == NULL)
-    exit_with_error ("Cannot open \"%s\" file (%s)", output_file,
+    exit_with_error ("Cannot open \"%s\" file (%s)", filename,
                      strerror (errno));
 
   if (ftell (f) == 0) {
-    fprintf (f, "%s;%s;%s;%s;%s;%s;%s;%s;%s;%s;%s;%s;%s;%s;%s;%s;%s\n",
+    fprintf (f, "%s;%s;%s;%s;%s;%s;%s;%s;%s;%s;%s;%s;%s;%s;%s;%s;%s",
              "machine", "size", "tilew", "tileh", "threads", "kernel",
              "variant", "tiling", "iterations", "schedule", "places", "label",
              "arg", "config", "time", "total_cycles", "total_stalls");
+    if (with_mpi)
+      fprintf (f, ";%s;%s;%s", "mpi_msgs", "mpi_bytes", "mpi_time");
+    fprintf (f, "\n");
   }
 
   if (uname (&s) < 0)
     exit_with_error ("uname failed (%s)", strerror (errno));
 
-  fprintf (
-      f,
-      "%s;%u;%u;%u;%u;%s;%s;%s;%u;%s;%s;%s;%s;%s;%ld;%" PRId64 ";%" PRId64 "\n",
-      s.nodename, DIM, TILE_W, TILE_H, easypap_requested_number_of_threads (),
-      kernel_name, variant_name, tile_name, nb_iter, easypap_omp_schedule (),
-      easypap_omp_places (), easypap_trace_label, (draw_param ?: "none"),
-      (config_param ?: "none"), time_in_us, total_cycles, total_stalls);
+  fprintf (f,
+           "%s;%u;%u;%u;%u;%s;%s;%s;%u;%s;%s;%s;%s;%s;%ld;%" PRId64
+           ";%" PRId64,
+           s.nodename, DIM, TILE_W, TILE_H,
+           easypap_requested_number_of_threads (), kernel_name, variant_name,
+           tile_name, nb_iter, easypap_omp_schedule (), easypap_omp_places (),
+           easypap_trace_label, (draw_param ?: "none"),
+           (config_param ?: "none"), time_in_us, total_cycles, total_stalls);
+  if (with_mpi)
+    fprintf (f, ";%" PRId64 ";%" PRId64 ";%" PRId64, mpi_msgs, mpi_bytes,
+             mpi_time);
+  fprintf (f, "\n");
 
   fclose (f);
 }
 
+static void output_perf_numbers (long time_in_us, unsigned nb_iter,
+                                 int64_t total_cycles, int64_t total_stalls)
+{
+  write_perf_numbers (output_file, 0, time_in_us, nb_iter, total_cycles,
+                      total_stalls);
+
+  // MPI totals go to a separate file (e.g. data.mpi.csv), so that the
+  // columns of the regular perf file never change
+  if (mpi_msgs != -1) {
+    char filename[MAX_FILENAME];
+    size_t len = strlen (output_file);
+
+    if (len >= 4 && !strcmp (output_file + len - 4, ".csv"))
+      len -= 4;
+    snprintf (filename, MAX_FILENAME, "%.*s.mpi.csv", (int)len, output_file);
+
+    write_perf_numbers (filename, 1, time_in_us, nb_iter, total_cycles,
+                        total_stalls);
+  }
+}
+
 static void usage (int val);
 
 static void filter_args (int *argc, char *argv[]);
@@ -200,6 +255,27 @@ static void generate_log_name (char *dest, size_t size, const char *prefix,
             iterations, (draw_param ?: "none"), extension);
 }
 
+static void generate_checkpoint_name (char *dest, size_t size)
+{
+  snprintf (dest, size, "data/ckpt/%s-%s-%s-dim-%d-arg-%s.ckpt", kernel_name,
+            variant_name, tile_name,
+            (easypap_mode == EASYPAP_MODE_2D_IMAGES) ? DIM : NB_CELLS,
+            (draw_param ?: "none"));
+}
+
+// Save a checkpoint each time 'iterations' crosses a multiple of the
+// checkpoint period (the_compute may advance by several iterations at once)
+static void checkpoint_if_required (int prev_iterations, int iterations)
+{
+  if (checkpoint_period &&
+      iterations / checkpoint_period != prev_iterations / checkpoint_period) {
+    char filename[MAX_FILENAME];
+
+    generate_checkpoint_name (filename, MAX_FILENAME);
+    ezp_checkpoint_save (filename, iterations);
+  }
+}
+
 static void init_phases (void)
 {
   if (easypap_mesh_file != NULL) {
@@ -209,7 +285,8 @@ static void init_phases (void)
 
 #ifdef ENABLE_MPI
   if (easypap_mpirun) {
-    int required = MPI_THREAD_FUNNELED;
+    int required =
+        mpi_thread_multiple ? MPI_THREAD_MULTIPLE : MPI_THREAD_FUNNELED;
     int provided;
 
     MPI_Init_thread (NULL, NULL, required, &provided);
@@ -217,6 +294,8 @@ static void init_phases (void)
     if (provided != required)
       PRINT_DEBUG ('M', "Note: MPI thread support level = %d\n", provided);
 
+    _easypap_mpi_thread_level = provided;
+
     MPI_Comm_rank (MPI_COMM_WORLD, &_easypap_mpi_rank);
     MPI_Comm_size (MPI_COMM_WORLD, &_easypap_mpi_size);
     PRINT_DEBUG ('i', "Init phase -1: MPI_Init_thread called (%d/%d)\n",
@@ -359,9 +438,17 @@ static void init_phases (void)
     PRINT_DEBUG ('i', "Init phase 2: [GPU init not required]\n");
 
   // Monitoring (either traces, or cpu footprints + perfmeters)
-  ezp_monitoring_init (easypap_requested_number_of_threads (),
+  ezp_monitoring_init (easypap_requested_number_of_threads () +
+                           mpi_prof_nb_lanes (),
                        easypap_number_of_gpus ());
 
+#ifdef ENABLE_MPI
+  if (easypap_mpirun && mpi_profiling)
+    ezp_mpi_prof_init (mpi_prof_nb_lanes ()
+                           ? (int)easypap_requested_number_of_threads ()
+                           : -1);
+#endif
+
   // OpenCL context is initialized, so we can safely call kernel dependent
   // init() func which may allocate additional buffers.
   if (the_init != NULL) {
@@ -396,7 +483,10 @@ static void init_phases (void)
     img_data_imgload ();
 
   // Appel de la fonction de dessin spécifique, si elle existe
-  if (the_draw != NULL) {
+  if (restart_file != NULL) {
+    restart_iteration = ezp_checkpoint_restore (restart_file);
+    PRINT_DEBUG ('i', "Init phase 6: state restored from %s\n", restart_file);
+  } else if (the_draw != NULL) {
     the_draw (draw_param);
     PRINT_DEBUG ('i', "Init phase 6: kernel-specific draw() hook called\n");
   } else
@@ -494,7 +584,8 @@ int main (int argc, char **argv)
 
   init_phases ();
 
-  iter_no = trace_starting_iteration;
+  iterations = restart_iteration;
+  iter_no    = trace_starting_iteration;
 
   // version graphique
   if (master_do_display) {
@@ -609,6 +700,8 @@ int main (int argc, char **argv)
 
             data_sync_on_host = 0;
 
+            int prev_iterations = iterations;
+
             if (n > 0) {
               iterations += n;
               stable = 1;
@@ -617,6 +710,11 @@ int main (int argc, char **argv)
             } else
               iterations += refresh_rate;
 
+            checkpoint_if_required (prev_iterations, iterations);
+#ifdef ENABLE_MPI
+            ezp_mpi_prof_end_iteration (iterations);
+#endif
+
             // Prepare screen refresh
             do_data_sync_if_required ();
 
@@ -643,8 +741,11 @@ int main (int argc, char **argv)
     int n;
 
     if (refresh_rate == 0) {
-      if (trace_may_be_used | do_thumbs)
+      // MPI statistics are recorded for each iteration
+      if (trace_may_be_used | do_thumbs | mpi_profiling)
         refresh_rate = 1;
+      else if (checkpoint_period)
+        refresh_rate = checkpoint_period;
       else if (max_iter)
         refresh_rate = max_iter;
       else
@@ -676,12 +777,19 @@ int main (int argc, char **argv)
 
         data_sync_on_host = 0;
 
+        int prev_iterations = iterations;
+
         if (n > 0) {
           iterations += n;
           stable = 1;
         } else
           iterations += refresh_rate;
 
+        checkpoint_if_required (prev_iterations, iterations);
+#ifdef ENABLE_MPI
+        ezp_mpi_prof_end_iteration (iterations);
+#endif
+
         if (do_thumbs && iterations >= trace_starting_iteration) {
 
           force_data_sync ();
@@ -700,6 +808,17 @@ int main (int argc, char **argv)
 
     PRINT_MASTER ("Computation completed after %d iterations\n", iterations);
 
+#ifdef ENABLE_MPI
+    if (easypap_mpirun && mpi_profiling) {
+      uint64_t msgs, bytes, time;
+
+      ezp_mpi_prof_get_totals (&msgs, &bytes, &time);
+      mpi_msgs  = msgs;
+      mpi_bytes = bytes;
+      mpi_time  = time;
+    }
+#endif
+
     if (easypap_proc_is_master ()) {
 #ifdef ENABLE_PAPI
       if (do_cache) {
@@ -760,6 +879,10 @@ int main (int argc, char **argv)
     }
   }
 
+#ifdef ENABLE_MPI
+  ezp_mpi_prof_finalize ();
+#endif
+
   ezp_monitoring_cleanup ();
 
   if (the_finalize != NULL)
@@ -794,6 +917,7 @@ static void usage (int val)
       "\t-a\t| --arg <string>\t: pass argument <string> to draw function\n"
       "\t-c\t| --config <string>\t: pass config argument <string> to config "
       "function\n"
+      "\t-ck\t| --checkpoint <n>\t: save a checkpoint every n iterations\n"
       "\t-d\t| --debug <flags>\t: enable debug messages (see debug.h)\n"
       "\t-du\t| --dump\t\t: dump final image to disk\n"
       "\t-ft\t| --first-touch\t\t: touch memory on different cores\n"
@@ -812,6 +936,10 @@ static void usage (int val)
       "\t-mg\t| --multi-gpu\t\t: use multiple GPUs if available\n"
       "\t-mpi\t| --mpirun <args>\t: pass <args> to the mpirun MPI process "
       "launcher\n"
+      "\t-mp\t| --mpi-profile\t\t: record MPI communication statistics "
+      "(per iteration)\n"
+      "\t-mtm\t| --mpi-thread-multiple\t: request MPI_THREAD_MULTIPLE "
+      "support\n"
       "\t-n\t| --no-display\t\t: avoid graphical display overhead\n"
       "\t-np\t| --nb-patches <N>\t: use N patches\n"
       "\t-nt\t| --nb-tiles <N>\t: use N x N tiles\n"
@@ -823,6 +951,8 @@ static void usage (int val)
       "\t-pc\t| --perf-counters\t: collect performance counters \n"
       "\t-q\t| --quit\t\t: exit once iterations are done\n"
       "\t-r\t| --refresh-rate <N>\t: display only 1/Nth of images\n"
+      "\t-rs\t| --restart <file>\t: resume computation from checkpoint "
+      "<file>\n"
       "\t-s\t| --size <DIM>\t\t: use image of size DIM x DIM\n"
       "\t-sh\t| --show-hash\t\t: display SHA256 hash of last image\n"
       "\t-si\t| --show-iterations\t: display iterations in main window\n"
@@ -990,6 +1120,18 @@ static void filter_args (int *argc, char *argv[])
       (*argc)--;
       argv++;
       config_param = *argv;
+    } else if (!strcmp (*argv, "--checkpoint") || !strcmp (*argv, "-ck")) {
+      if (*argc == 1)
+        usage_error ("Error: checkpoint period is missing");
+      (*argc)--;
+      argv++;
+      checkpoint_period = atoi (*argv);
+    } else if (!strcmp (*argv, "--restart") || !strcmp (*argv, "-rs")) {
+      if (*argc == 1)
+        usage_error ("Error: checkpoint filename is missing");
+      (*argc)--;
+      argv++;
+      restart_file = *argv;
     } else if (!strcmp (*argv, "--label") || !strcmp (*argv, "-lb")) {
       if (*argc == 1)
         usage_error ("Error: parameter string is missing");
@@ -1007,6 +1149,19 @@ static void filter_args (int *argc, char *argv[])
       (*argc)--;
       argv++;
       easypap_mpirun = 1;
+#endif
+    } else if (!strcmp (*argv, "--mpi-profile") || !strcmp (*argv, "-mp")) {
+#ifndef ENABLE_MPI
+      warning (*argv, "ENABLE_MPI", NULL);
+#else
+      mpi_profiling = 1;
+#endif
+    } else if (!strcmp (*argv, "--mpi-thread-multiple") ||
+               !strcmp (*argv, "-mtm")) {
+#ifndef ENABLE_MPI
+      warning (*argv, "ENABLE_MPI", NULL);
+#else
+      mpi_thread_multiple = 1;
 #endif
     } else if (!strcmp (*argv, "--gpu") || !strcmp (*argv, "-g")) {
 #if defined(ENABLE_OPENCL) || defined(ENABLE_CUDA)